@@ -0,0 +1,298 @@
+#include "../src/collision_detector.h"
+#include "../src/collision_kernel.h"
+#include "../src/spatial_hash.h"
+
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace json = boost::json;
+
+namespace {
+
+    using collision_detector::BroadPhase;
+    using collision_detector::Gatherer;
+    using collision_detector::Item;
+
+    constexpr double GATHERER_WIDTH = 0.6;
+    constexpr double MAX_STEP = 1.;
+    constexpr double ROAD_SPACING = 10.;
+    constexpr double HASH_CELL_SIZE = 2.;
+    constexpr int CLUSTERS = 8;
+
+    struct Args {
+        size_t min_count = 10;
+        size_t max_count = 50000;
+        double min_time = 0.2;
+        double max_brute_pairs = 3e9;
+        unsigned seed = 42;
+    };
+
+    [[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+        namespace po = boost::program_options;
+
+        po::options_description desc{"Allowed options"s};
+        Args args;
+        desc.add_options()
+            ("help,h", "produced help message")
+            ("min-count", po::value(&args.min_count)->value_name("count"s), "set smallest number of gatherers and items")
+            ("max-count", po::value(&args.max_count)->value_name("count"s), "set largest number of gatherers and items")
+            ("min-time", po::value(&args.min_time)->value_name("seconds"s), "set time to repeat every measurement for")
+            ("max-brute-pairs", po::value(&args.max_brute_pairs)->value_name("pairs"s), "skip the brute force above this number of pairs")
+            ("seed", po::value(&args.seed)->value_name("seed"s), "set seed of the workloads");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+
+        if (vm.contains("help"s)) {
+            std::cout << desc;
+            return std::nullopt;
+        }
+        if (args.min_count == 0) {
+            throw std::runtime_error("Smallest count must be positive"s);
+        }
+        if (args.min_count > args.max_count) {
+            throw std::runtime_error("Smallest count is larger than the largest one"s);
+        }
+        return args;
+    }
+
+    long PeakRssKb() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    // Tracks the peak number of bytes held through it
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t GetPeak() const {
+            return peak_;
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            in_use_ += bytes;
+            peak_ = std::max(peak_, in_use_);
+            return p;
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            in_use_ -= bytes;
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        size_t in_use_ = 0;
+        size_t peak_ = 0;
+    };
+
+    struct Workload {
+        std::vector<Item> items;
+        std::vector<Gatherer> gatherers;
+    };
+
+    // Gatherers move along one axis like dogs do; the world grows with the counts
+    // so that the density of objects stays the same.
+    class WorkloadGenerator {
+    public:
+        WorkloadGenerator(unsigned seed, size_t gatherers, size_t items)
+            : generator_{seed}
+            , side_{ROAD_SPACING * std::ceil(std::sqrt(static_cast<double>(std::max(gatherers, items))) / 10.)} {
+            std::uniform_real_distribution<double> coord{0., side_};
+            for (int i = 0; i < CLUSTERS; i++) {
+                centers_.push_back({coord(generator_), coord(generator_)});
+            }
+        }
+
+        Workload Make(const std::string& distribution, size_t gatherers, size_t items) {
+            Workload workload;
+            for (size_t i = 0; i < items; i++) {
+                workload.items.push_back({Point(distribution), 0.});
+            }
+            std::uniform_real_distribution<double> step{-MAX_STEP, MAX_STEP};
+            std::bernoulli_distribution horizontal;
+            for (size_t i = 0; i < gatherers; i++) {
+                geom::Point2D start = Point(distribution);
+                geom::Point2D end = start;
+                (horizontal(generator_) ? end.x : end.y) += step(generator_);
+                workload.gatherers.push_back({i, start, end, GATHERER_WIDTH});
+            }
+            return workload;
+        }
+
+    private:
+        geom::Point2D Point(const std::string& distribution) {
+            std::uniform_real_distribution<double> coord{0., side_};
+            if (distribution == "clustered"s) {
+                const auto& center = centers_[std::uniform_int_distribution<int>{0, CLUSTERS - 1}(generator_)];
+                std::normal_distribution<double> offset{0., side_ / 40.};
+                return {center.x + offset(generator_), center.y + offset(generator_)};
+            }
+            if (distribution == "roads"s) {
+                const int roads = static_cast<int>(side_ / ROAD_SPACING);
+                const double road = ROAD_SPACING * std::uniform_int_distribution<int>{0, roads}(generator_);
+                if (std::bernoulli_distribution{}(generator_)) {
+                    return {coord(generator_), road};
+                }
+                return {road, coord(generator_)};
+            }
+            return {coord(generator_), coord(generator_)};
+        }
+
+        std::mt19937 generator_;
+        double side_;
+        std::vector<geom::Point2D> centers_;
+    };
+
+    struct Measurement {
+        size_t events = 0;
+        size_t runs = 0;
+        double seconds_per_run = 0;
+        size_t peak_bytes = 0;
+    };
+
+    // Repeats the query after a warm-up run until min_time has passed
+    template <typename Query>
+    Measurement Measure(double min_time, Query&& query) {
+        query(std::pmr::new_delete_resource());
+        Measurement result;
+        std::chrono::nanoseconds total{0};
+        do {
+            CountingResource resource;
+            auto start = std::chrono::steady_clock::now();
+            auto events = query(&resource);
+            total += std::chrono::steady_clock::now() - start;
+            result.events = events.size();
+            result.peak_bytes = std::max(result.peak_bytes, resource.GetPeak());
+            ++result.runs;
+        } while (std::chrono::duration<double>(total).count() < min_time);
+        result.seconds_per_run = std::chrono::duration<double>(total).count() / result.runs;
+        return result;
+    }
+
+    // JSON has no infinity or NaN, so ratios of zero times are written as null
+    json::value Number(double value) {
+        if (std::isfinite(value)) {
+            return value;
+        }
+        return nullptr;
+    }
+
+    class Report {
+    public:
+        void Begin(const std::string& distribution, size_t gatherers, size_t items) {
+            workload_.clear();
+            workload_["distribution"] = distribution;
+            workload_["gatherers"] = gatherers;
+            workload_["items"] = items;
+        }
+
+        void Add(const std::string& variant, const Measurement& m, double pairs, std::optional<double> baseline) {
+            json::object result = workload_;
+            result["variant"] = variant;
+            result["events"] = m.events;
+            result["runs"] = m.runs;
+            result["secondsPerRun"] = m.seconds_per_run;
+            result["eventsPerSec"] = Number(m.events / m.seconds_per_run);
+            result["nsPerPair"] = Number(m.seconds_per_run * 1e9 / pairs);
+            result["peakBytes"] = m.peak_bytes;
+            if (baseline) {
+                result["speedupVsBruteForce"] = Number(*baseline / m.seconds_per_run);
+            }
+            results_.push_back(std::move(result));
+        }
+
+        json::object Finish() {
+            json::object document;
+            document["kernel"] = collision_detector::GetKernelName();
+            document["results"] = std::move(results_);
+            document["peakRssKb"] = PeakRssKb();
+            return document;
+        }
+
+    private:
+        json::object workload_;
+        json::array results_;
+    };
+
+    void RunWorkload(const Args& args, Report& report, const std::string& distribution, size_t gatherer_count, size_t item_count) {
+        WorkloadGenerator generator{args.seed, gatherer_count, item_count};
+        Workload workload = generator.Make(distribution, gatherer_count, item_count);
+        const std::span<const Item> items{workload.items};
+        const std::span<const Gatherer> gatherers{workload.gatherers};
+        const double pairs = static_cast<double>(gatherer_count) * static_cast<double>(item_count);
+        report.Begin(distribution, gatherer_count, item_count);
+
+        std::optional<double> baseline;
+        if (pairs <= args.max_brute_pairs) {
+            auto m = Measure(args.min_time, [&](auto* resource) {
+                return collision_detector::FindGatherEvents(items, gatherers, resource, BroadPhase::NONE);
+            });
+            baseline = m.seconds_per_run;
+            report.Add("bruteForce"s, m, pairs, std::nullopt);
+        }
+        report.Add("uniformGrid"s, Measure(args.min_time, [&](auto* resource) {
+            return collision_detector::FindGatherEvents(items, gatherers, resource, BroadPhase::UNIFORM_GRID);
+        }), pairs, baseline);
+        report.Add("auto"s, Measure(args.min_time, [&](auto* resource) {
+            return collision_detector::FindGatherEvents(items, gatherers, resource, BroadPhase::AUTO);
+        }), pairs, baseline);
+
+        // the index is persistent in the game, so only queries are measured
+        collision_detector::SpatialHash hash{HASH_CELL_SIZE};
+        for (size_t i = 0; i < workload.items.size(); i++) {
+            hash.Insert(i, workload.items[i]);
+        }
+        report.Add("spatialHash"s, Measure(args.min_time, [&](auto* resource) {
+            return collision_detector::FindGatherEvents(hash, gatherers, resource);
+        }), pairs, baseline);
+    }
+
+    std::vector<size_t> Counts(const Args& args) {
+        std::vector<size_t> counts;
+        for (size_t count = args.min_count; count < args.max_count; count *= 10) {
+            counts.push_back(count);
+        }
+        counts.push_back(args.max_count);
+        return counts;
+    }
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        if (auto args = ParseCommandLine(argc, argv)) {
+            Report report;
+            for (const std::string distribution : {"uniform", "clustered", "roads"}) {
+                for (size_t gatherers : Counts(*args)) {
+                    for (size_t items : Counts(*args)) {
+                        RunWorkload(*args, report, distribution, gatherers, items);
+                    }
+                }
+            }
+            std::cout << json::serialize(report.Finish()) << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
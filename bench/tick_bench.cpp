@@ -0,0 +1,126 @@
+#include "../src/app.h"
+#include "../src/json_loader.h"
+#include "../tests/null_retired_dogs.h"
+
+#include <boost/program_options.hpp>
+#include <sys/resource.h>
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+
+using namespace std::literals;
+
+namespace {
+
+    struct Args {
+        std::string config_file = "data/config.json";
+        int ticks = 200;
+        int tick_period = 50;
+        int max_dogs = 100000;
+        unsigned tick_threads = 1;
+        double turn_probability = 0.05;
+        unsigned seed = 42;
+    };
+
+    [[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+        namespace po = boost::program_options;
+
+        po::options_description desc{"Allowed options"s};
+        Args args;
+        desc.add_options()
+            ("help,h", "produced help message")
+            ("config-file,c", po::value(&args.config_file)->value_name("file"s), "set config path")
+            ("ticks", po::value(&args.ticks)->value_name("count"s), "set number of ticks per run")
+            ("tick-period,t", po::value(&args.tick_period)->value_name("milliseconds"s), "set simulated tick period")
+            ("max-dogs", po::value(&args.max_dogs)->value_name("count"s), "set largest number of dogs per map")
+            ("tick-threads", po::value(&args.tick_threads)->value_name("threads"s), "set number of threads ticking game sessions")
+            ("turn-probability", po::value(&args.turn_probability)->value_name("probability"s), "set chance of a dog turning every tick")
+            ("seed", po::value(&args.seed)->value_name("seed"s), "set seed of the simulation and dog turns");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+
+        if (vm.contains("help"s)) {
+            std::cout << desc;
+            return std::nullopt;
+        }
+        return args;
+    }
+
+    long PeakRssKb() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    void RunBenchmark(const Args& args, int dogs_per_map) {
+        model::Game game = json_loader::LoadGame(args.config_file);
+        game.SetRandomaizer();
+        game.SetSeed(args.seed);
+        test_support::NullRetiredDogRepository retired_dogs;
+        app::Application app{game, retired_dogs};
+        app.SetTickThreads(args.tick_threads);
+
+        std::vector<std::shared_ptr<model::Dog>> dogs;
+        dogs.reserve(static_cast<size_t>(dogs_per_map) * game.GetMaps().size());
+        for (const auto& map : game.GetMaps()) {
+            auto session = game.FindSession(map.GetId());
+            for (int i = 0; i < dogs_per_map; i++) {
+                auto result = app.JoinGame(*map.GetId(), "dog"s + std::to_string(i));
+                dogs.push_back(session->FindDog(result.user_id));
+            }
+        }
+
+        const std::array directions{model::Direction::NORTH, model::Direction::SOUTH,
+                                    model::Direction::WEST, model::Direction::EAST};
+        std::mt19937 generator{args.seed};
+        std::bernoulli_distribution turn{args.turn_probability};
+        std::uniform_int_distribution<size_t> direction(0, directions.size() - 1);
+        for (auto& dog : dogs) {
+            dog->ChangeDirection(directions[direction(generator)]);
+        }
+
+        const std::chrono::milliseconds delta{args.tick_period};
+        std::chrono::nanoseconds tick_time{0};
+        for (int tick = 0; tick < args.ticks; tick++) {
+            for (auto& dog : dogs) {
+                if (turn(generator)) {
+                    dog->ChangeDirection(directions[direction(generator)]);
+                }
+            }
+            auto start = std::chrono::steady_clock::now();
+            app.Tick(delta);
+            tick_time += std::chrono::steady_clock::now() - start;
+        }
+
+        const double seconds = std::chrono::duration<double>(tick_time).count();
+        const double ns_per_dog = static_cast<double>(tick_time.count()) / args.ticks / dogs.size();
+        std::cout << std::setw(10) << dogs_per_map
+                  << std::setw(12) << dogs.size()
+                  << std::setw(14) << std::fixed << std::setprecision(1) << args.ticks / seconds
+                  << std::setw(14) << std::setprecision(1) << ns_per_dog
+                  << std::setw(14) << PeakRssKb()
+                  << std::setw(20) << std::hex << app.GetChecksum() << std::dec << std::endl;
+    }
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        if (auto args = ParseCommandLine(argc, argv)) {
+            std::cout << std::setw(10) << "dogs/map" << std::setw(12) << "dogs" << std::setw(14) << "ticks/s"
+                      << std::setw(14) << "ns/dog/tick" << std::setw(14) << "peak_rss_kb" << std::setw(20) << "checksum" << std::endl;
+            for (int dogs_per_map = 10; dogs_per_map <= args->max_dogs; dogs_per_map *= 10) {
+                RunBenchmark(*args, dogs_per_map);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -1,5 +1,7 @@
 #include "app.h"
 
+#include <iomanip>
+
 namespace app {
 
     Player::Player(std::shared_ptr<model::GameSession> session, std::shared_ptr<model::Dog> dog)
@@ -27,12 +29,14 @@ namespace app {
     } 
 
     Token PlayerTokens::CreateRandomToken() {
-        std::default_random_engine generator1(random_device_());
-        std::default_random_engine generator2(random_device_());
-        std::uniform_int_distribution<uint64_t> distribution(0x1000000000000000,0xFFFFFFFFFFFFFFFF); 
+        // tokens are credentials, so all 128 bits come from the OS instead of a seeded engine;
+        // zero padding keeps leading zero digits instead of forcing them to be non-zero
+        auto random_half = [this] {
+            return (static_cast<uint64_t>(random_device_()) << 32) | random_device_();
+        };
         std::stringstream str;
-        str << std::hex << distribution(generator1) <<  distribution(generator2);
-        str.width(TOKEN_SIZE);
+        str << std::hex << std::setfill('0') << std::setw(TOKEN_SIZE / 2) << random_half()
+            << std::setw(TOKEN_SIZE / 2) << random_half();
         return Token{str.str()};
     }
 
@@ -95,28 +99,6 @@ namespace app {
         players_.DeletePlayer(dog->GetDogId(), map_id);
     }
 
-    LostObjDogProvider::LostObjDogProvider(const std::vector<collision_detector::Item>& items,
-                                const std::vector<collision_detector::Gatherer>& gatherers)
-        : items_(items)
-        , gatherers_(gatherers) 
-    {}
-     
-    size_t LostObjDogProvider::ItemsCount() const  {
-        return items_.size();
-    }
-
-    collision_detector::Item LostObjDogProvider::GetItem(size_t idx) const  {
-        return items_.at(idx);
-    }
-
-    size_t LostObjDogProvider::GatherersCount() const {
-        return gatherers_.size();
-    }
-
-    collision_detector::Gatherer LostObjDogProvider::GetGatherer(size_t idx) const  {
-        return gatherers_.at(idx);
-    }
-
     ListMapsUseCase::ListMapsUseCase(const model::Game& game)
         : game_(&game)
     {}
@@ -177,7 +159,7 @@ namespace app {
     const GetStateUseCase::GameStateResult GetStateUseCase::State(const Token& token) const {
         auto player = tokens_->FindPlayerByToken(token);
         if(player){
-            return {player->GetSession()->GetInfoDogs(), player->GetSession()->GetLostObjects()};
+            return {player->GetSession()->GetSnapshot()};
         }
         throw ApiError::TokenUnknown; 
     }
@@ -192,186 +174,303 @@ namespace app {
         auto player = tokens_->FindPlayerByToken(token);
         if(player){
             player->GetDog()->ChangeDirection(dir); 
+            player->GetSession()->InvalidateSnapshot();
         }
         else{
             throw ApiError::TokenUnknown;   
         }            
     }
 
-    TickUseCase::TickUseCase(model::Game& game, postgres::DataBase& game_db)
+    TickUseCase::TickUseCase(model::Game& game, model::RetiredDogRepository& retired_dogs)
         : game_(&game)
-        , game_db_(game_db)
+        , retired_dogs_repository_(retired_dogs)
+        , gather_parallel_for_([this](size_t count, const std::function<void(size_t)>& job){
+            ParallelFor(count, job);
+        })
     {}
 
-    bool TickUseCase::IsPosBelongToRoad(const model::Position& pos, const model::FieldRoad& field_road) {
-        constexpr double eps = 1e-10;
-        return (field_road.up_left.x < pos.x || std::abs(pos.x - field_road.up_left.x) < eps) && 
-               (pos.x < field_road.down_right.x || std::abs(field_road.down_right.x - pos.x) < eps) &&
-               (field_road.up_left.y < pos.y || std::abs(pos.y - field_road.up_left.y) < eps) && 
-               (pos.y < field_road.down_right.y || std::abs(field_road.down_right.y - pos.y) < eps);
-    }
-
-    std::vector<model::FieldRoad> TickUseCase::GetContainRoads(const model::Map map, const model::Position& pos) {
-        std::vector<model::FieldRoad> contain_roads;
-        for(const auto& road : map.GetRoads()){                      
-            const model::Point& start = road.GetStart();
-            const model::Point& end = road.GetEnd();
-            model::FieldRoad field_road{{std::min(start.x, end.x) - model::ObjectsWidth::ROAD_WIDTH, 
-                                            std::min(start.y, end.y) - model::ObjectsWidth::ROAD_WIDTH}, 
-                                        {std::max(start.x, end.x) + model::ObjectsWidth::ROAD_WIDTH, 
-                                            std::max(start.y, end.y) + model::ObjectsWidth::ROAD_WIDTH}};
-            if(IsPosBelongToRoad(pos, field_road)){ 
-                contain_roads.push_back(field_road);
-            }                       
-        }
-        return contain_roads;
-    }
-
-    double TickUseCase::FindNearestPoint(double axis_point_l, double  axis_point_b, double mid_point, double new_point) {       
-        if(std::abs(new_point - axis_point_l) < std::abs(new_point - axis_point_b)){
-            if(std::abs(new_point - axis_point_l) < std::abs(new_point - mid_point)){
-                return axis_point_l;
-            }
-        }
-        else {
-            if(std::abs(new_point - axis_point_b) < std::abs(new_point - mid_point)){
-                return axis_point_b;
+    std::pmr::vector<collision_detector::Gatherer> TickUseCase::MakeGatherersData(const model::Map& map, model::GameSession& session, 
+                                                                std::chrono::milliseconds delta, std::pmr::memory_resource* resource) {
+        const auto& targets = session.GetKinematics().Integrate(delta);
+        std::pmr::vector<collision_detector::Gatherer> gatherers{resource};
+        gatherers.reserve(session.GetKinematics().MovingCount());
+        for(auto& dog : session.GetInfoDogs()) { 
+            if(dog.second->IsStopped()){
+                continue;
             }
+            model::Position current_pos = dog.second->GetPosition();
+            auto move = model::MoveDog(map, *dog.second, targets[dog.second->GetKinematicsSlot()]); 
+
+            gatherers.emplace_back(collision_detector::Gatherer{static_cast<size_t>(dog.second->GetDogId()), 
+                                            {current_pos.x,current_pos.y},
+                                            move.end, 
+                                            model::ObjectsWidth::DOG_WIDTH}); 
         }
-        return mid_point;
+        return gatherers;
     }
 
-    model::Position TickUseCase::MakeMove(std::shared_ptr<model::Dog> dog, const std::vector<model::FieldRoad>& roads, 
-                                                                model::Position new_pos, model::Position mid_pos) {
-        for(const auto& road : roads){
-            if(IsPosBelongToRoad(new_pos, road)){
-                dog->ChangePosition(new_pos);
-                return new_pos;
-            }
-            if((road.up_left.x > new_pos.x) || (new_pos.x > road.down_right.x)){
-                mid_pos.x = FindNearestPoint(road.up_left.x, road.down_right.x, mid_pos.x, new_pos.x);
+    std::pmr::vector<model::GameSession::LootHandle> TickUseCase::ExecuteActionEvents(
+                                    const std::pmr::vector<collision_detector::GatheringEvent>& loot_events, 
+                                    const std::pmr::vector<collision_detector::GatheringEvent>& office_events,
+                                    std::shared_ptr<model::GameSession> session, std::pmr::memory_resource* resource) {    
+        using model::GameSession;
+        std::pmr::vector<GameSession::LootHandle> items_for_delete{resource};
+        auto& dogs = session->GetInfoDogs();
+        auto& lost_objects = session->GetLootSlots();
+        // one bit per slot: an object can be picked up once per tick
+        std::pmr::vector<uint64_t> collected((lost_objects.SlotCount() + 63) / 64, 0, resource);
+        auto loot = loot_events.begin();
+        auto office = office_events.begin();
+        while(loot != loot_events.end() || office != office_events.end()){
+            const bool pickup = office == office_events.end() || (loot != loot_events.end() 
+                && std::tie(loot->time, loot->gatherer_id) <= std::tie(office->time, office->gatherer_id));
+            if(pickup) { 
+                const auto& event = *loot++;
+                const auto handle = GameSession::LootHandle::FromId(event.item_id);
+                const uint64_t bit = uint64_t{1} << (handle.index % 64);
+                if(!(collected[handle.index / 64] & bit)){
+                    const auto& obj = lost_objects.At(handle);
+                    if(dogs[event.gatherer_id]->PutInBag({obj.id, obj.type_loot})){
+                        collected[handle.index / 64] |= bit;
+                        items_for_delete.push_back(handle);
+                    }
+                }
             }
-            if((road.up_left.y > new_pos.y) || (new_pos.y > road.down_right.y)){
-                mid_pos.y = FindNearestPoint(road.up_left.y, road.down_right.y, mid_pos.y, new_pos.y);
+            else { 
+                session->ExchangeItemForScore((office++)->gatherer_id);
             }
         }
-        dog->ChangePosition(mid_pos);
-        dog->StopMove();
-        return mid_pos; 
+        return items_for_delete;
     }
 
-    std::vector<collision_detector::Gatherer> TickUseCase::MakeGatherersData(const model::Map& map, model::GameSession::Dogs& dogs, 
-                                                                                                    std::chrono::milliseconds delta) {
-        std::vector<collision_detector::Gatherer> gatherers;
-        for(auto& dog : dogs) { 
-            model::Speed dog_speed = dog.second->GetSpeed();
-            model::Position current_pos = dog.second->GetPosition();
-            std::vector<model::FieldRoad> contain_roads = GetContainRoads(map, current_pos);
-            model::Position new_pos{{current_pos.x + dog_speed.w * delta.count() * model::ConvertValues::MS_TO_S }, 
-                                     current_pos.y + dog_speed.h * delta.count() * model::ConvertValues::MS_TO_S };
-            model::Position mid_pos{current_pos.x, current_pos.y};
-
-            auto res_pos = MakeMove(dog.second, contain_roads, new_pos, mid_pos); 
-
-            gatherers.emplace_back(collision_detector::Gatherer{static_cast<size_t>(dog.second->GetDogId()), 
-                                            {current_pos.x,current_pos.y},
-                                            {res_pos.x,res_pos.y}, 
-                                            model::ObjectsWidth::DOG_WIDTH}); 
+    void TickUseCase::SetThreads(unsigned threads) {
+        workers_.reset();
+        threads_ = std::max(threads, 1u);
+        if(threads > 1){
+            workers_ = std::make_unique<net::thread_pool>(threads);
         }
-        return gatherers;
     }
 
-    std::vector<collision_detector::Item> TickUseCase::MakeItemsData(const model::Map& map, const model::GameSession::LostObjects& lost_objects) {
-        const auto& offices = map.GetOffices();
-        std::vector<collision_detector::Item> items(lost_objects.size() + offices.size());
+    void TickUseCase::TickSession(size_t index, std::chrono::milliseconds delta) {
+        using tick_profiler::Phase;
+        using tick_profiler::ScopedTimer;
+        using tick_budget::Level;
+
+        const model::Map& map = *sessions_[index].first;
+        const auto& session = sessions_[index].second;
+        auto* profile = profiles_[index];
+        auto& dogs_to_delete = dogs_to_delete_[index];
+        const size_t stagger = tick_count_ + index;
+
+        ScopedTimer session_timer{profile, Phase::SESSION};
+        auto* arena = session->GetTickArena().GetResource();
+        auto& backlog = session->GetTickBacklog();
+        backlog.loot += delta;
+        if(level_ < Level::REDUCED_LOOT || stagger % REDUCED_LOOT_STRIDE == 0) {
+            ScopedTimer timer{profile, Phase::LOOT_GENERATION};
+            int item_type_count = map.GetValueLoots().size();
+            session->GenerateNewLoot(backlog.loot, item_type_count);
+            backlog.loot = 0ms;
+        }
 
-        auto push_lost_obj = [](const auto& obj){
-            return collision_detector::Item{{obj.pos.x, obj.pos.y}, model::ObjectsWidth::LOST_OBJ_WIDTH};
-        };
-        std::transform(lost_objects.begin(), lost_objects.end(), items.begin(), push_lost_obj);
+        {
+            ScopedTimer timer{profile, Phase::INACTIVITY};
+            std::pmr::vector<int> inactive_dogs{arena};
+            session->AdvanceClock(delta, inactive_dogs);
+            for(int dog_id : inactive_dogs){
+                dogs_to_delete.emplace_back(dog_id, session->GetInfoDogs().at(dog_id)->GetPlayTime());
+            }
+        }
 
-        auto push_offices = [](const auto& office){
-            const auto& pos = office.GetPosition();
-            return collision_detector::Item{{static_cast<double>(pos.x), static_cast<double>(pos.y)}, model::ObjectsWidth::OFFICE_WIDTH};
-        };
-        std::transform(offices.begin(), offices.end(), items.end() - 1, push_offices);
+        backlog.movement += delta;
+        // A skipped tick is only allowed while the catch-up move stays within the gather radius
+        const double tick_distance = map.GetSpeed() * delta.count() * model::ConvertValues::MS_TO_S;
+        const bool slow_session = 2 * tick_distance < model::ObjectsWidth::DOG_WIDTH + model::ObjectsWidth::LOST_OBJ_WIDTH;
+        if(level_ >= Level::SPARSE_COLLISIONS && slow_session && stagger % 2 == 1){
+            return;
+        }
+        const auto move_time = backlog.movement;
+        backlog.movement = 0ms;
+        if(!session->HasMovingDogs()){
+            return;
+        }
+        session->InvalidateSnapshot();
 
-        return items;
+        std::pmr::vector<collision_detector::Gatherer> gatherers{arena};
+        {
+            ScopedTimer timer{profile, Phase::GATHERERS};
+            gatherers = MakeGatherersData(map, *session, move_time, arena);
+        }
+      
+        std::pmr::vector<collision_detector::GatheringEvent> loot_events{arena};
+        std::pmr::vector<collision_detector::GatheringEvent> office_events{arena};
+        {
+            ScopedTimer timer{profile, Phase::GATHER_EVENTS};
+            loot_events = collision_detector::FindGatherEvents(session->GetLootIndex(), gatherers, arena, GetGatherParallelism(index));
+            office_events = collision_detector::FindGatherEvents(map.GetOfficeItems(), gatherers, arena);
+        }
+        std::pmr::vector<model::GameSession::LootHandle> items_for_delete{arena};
+        {
+            ScopedTimer timer{profile, Phase::ACTION_EVENTS};
+            items_for_delete = ExecuteActionEvents(loot_events, office_events, session, arena);
+        }
+        if(!items_for_delete.empty()) {
+            ScopedTimer timer{profile, Phase::REMOVE_ITEMS};
+            session->RemoveCollectedItems(items_for_delete);
+        }
     }
 
-    std::set<int> TickUseCase::ExecuteActionEvents(std::vector<collision_detector::GatheringEvent>& dog_events, 
-                                                        std::shared_ptr<model::GameSession> session, LostObjDogProvider& prov) {    
-        std::set<int> items_for_delete;
-        auto& dogs = session->GetInfoDogs();
-        auto& lost_objects = session->GetLostObjects();
-        for(const auto& event : dog_events){
-            if(prov.GetItem(event.item_id).width == 0) { 
-                if(!items_for_delete.count(event.item_id)){
-                    auto obj = lost_objects[event.item_id];
-                     if(dogs[event.gatherer_id]->PutInBag({obj.id, obj.type_loot})){
-                        items_for_delete.insert(event.item_id);
-                    }
+    template <typename Fn>
+    void TickUseCase::ParallelFor(size_t count, Fn&& fn) {
+        errors_.assign(count, nullptr);
+        std::latch done(count);
+        for(size_t i = 0; i < count; i++){
+            net::post(*workers_, [&, i]{
+                try {
+                    fn(i);
+                } catch (...) {
+                    errors_[i] = std::current_exception();
                 }
+                done.count_down();
+            });
+        }
+        done.wait();
+        for(const auto& error : errors_){
+            if(error){
+                std::rethrow_exception(error);
             }
-            else { 
-                session->ExchangeItemForScore(event.gatherer_id);
+        }
+    }
+
+    template <typename Fn>
+    void TickUseCase::ForEachSession(Fn&& fn) {
+        if(workers_ && sessions_.size() > 1){
+            ParallelFor(sessions_.size(), fn);
+        }
+        else {
+            for(size_t i = 0; i < sessions_.size(); i++){
+                fn(i);
             }
         }
-        return items_for_delete;
+    }
+
+    collision_detector::Parallelism TickUseCase::GetGatherParallelism(size_t index) const {
+        if(!crowded_[index]){
+            return {};
+        }
+        return {&gather_parallel_for_, threads_};
     }
 
     void TickUseCase::Tick(std::chrono::milliseconds delta) {
+        const auto tick_start = std::chrono::steady_clock::now();
+        ClearTickData();
         for(const auto& map : game_->GetMaps()){
-            auto session = game_->FindSession(map.GetId());
-            if(session){
-                int item_type_count = map.GetValueLoots().size();
-                session->GenerateNewLoot(delta, item_type_count);
-
-                auto& dogs = session->GetInfoDogs();
-                std::vector<std::pair<int, std::chrono::milliseconds>> dogs_to_delete;
-                for(const auto& dog: dogs){
-                    if(auto dele = dog.second->InActiveDog(delta)){
-                        dogs_to_delete.push_back({dog.second->GetDogId(), dele.value()});
-                    }
-                }  
-                std::vector<collision_detector::Gatherer> gatherers = MakeGatherersData(map, dogs, delta);
-                auto& lost_objects = session->GetLostObjects();
-                std::vector<collision_detector::Item> items = MakeItemsData(map, lost_objects);
-              
-                LostObjDogProvider obj_dogs{items, gatherers};
-                auto dog_events = collision_detector::FindGatherEvents(obj_dogs);
-                std::set<int> items_for_delete = ExecuteActionEvents(dog_events, session, obj_dogs);
-                if(!items_for_delete.empty()) {
-                    session->RemoveCollectedItems(items_for_delete);
-                }
-              
-                for(const auto& dog : dogs_to_delete){
-                    auto retir_dog = session->DeleteDog(dog.first, dog.second);
-                    game_db_.SaveRetiredDog(retir_dog);
-                }      
+            if(auto session = game_->FindSession(map.GetId())){
+                sessions_.emplace_back(&map, session);
+                profiles_.push_back(profiler_.GetMap(*map.GetId()));
+                dogs_to_delete_.emplace_back(session->GetTickArena().Reset());
+                crowded_.push_back(workers_ && session->GetKinematics().MovingCount() >= collision_detector::PARALLEL_MIN_GATHERERS);
+            }
+        }
+
+        // Crowded sessions are ticked on this thread after the others, so that
+        // their collision search can spread over the workers
+        ForEachSession([this, delta](size_t i){
+            if(!crowded_[i]){
+                TickSession(i, delta);
+            }
+        });
+        for(size_t i = 0; i < sessions_.size(); i++){
+            if(crowded_[i]){
+                TickSession(i, delta);
+            }
+        }
+
+        for(size_t i = 0; i < sessions_.size(); i++){
+            for(const auto& dog : dogs_to_delete_[i]){
+                retired_dogs_.emplace_back(profiles_[i], sessions_[i].second->DeleteDog(dog.first, dog.second));
+            }
+        }
+        ForEachSession([this](size_t i){
+            tick_profiler::ScopedTimer timer{profiles_[i], tick_profiler::Phase::PUBLISH_SNAPSHOT};
+            sessions_[i].second->PublishSnapshot();
+        });
+        if(level_ < tick_budget::Level::DEFERRED_RETIREMENT){
+            FlushRetiredDogs();
+        }
+        ClearTickData();
+        ++tick_count_;
+        if(game_->GetSeed()){
+            // Replays must not depend on wall time, so a seeded game is never degraded
+            game_->UpdateChecksum();
+            return;
+        }
+        level_ = budget_.Record(std::chrono::steady_clock::now() - tick_start);
+    }
+
+    size_t TickUseCase::GetTickCount() const {
+        return tick_count_;
+    }
+
+    void TickUseCase::FlushRetiredDogs() {
+        size_t saved = 0;
+        try {
+            for(; saved < retired_dogs_.size(); saved++){
+                const auto& [profile, retired_dog] = retired_dogs_[saved];
+                tick_profiler::ScopedTimer timer{profile, tick_profiler::Phase::SAVE_RETIRED};
+                retired_dogs_repository_.Save(model::RetiredDog{model::RetiredDogId::New(), retired_dog.name, retired_dog.score, retired_dog.play_time});
             }
+        } catch (...) {
+            retired_dogs_.erase(retired_dogs_.begin(), retired_dogs_.begin() + saved);
+            throw;
         }
+        retired_dogs_.clear();
     }
 
-    RecordsUseCase::RecordsUseCase(const postgres::DataBase& game_db)
-        : game_db_(game_db)
+    void TickUseCase::SetBudget(std::chrono::milliseconds budget) {
+        budget_.SetBudget(budget);
+        level_ = budget_.GetLevel();
+    }
+
+    void TickUseCase::SetDegradationLevel(tick_budget::Level level) {
+        budget_.SetLevel(level);
+        level_ = level;
+    }
+
+    tick_budget::Level TickUseCase::GetDegradationLevel() const {
+        return budget_.GetLevel();
+    }
+
+    void TickUseCase::ClearTickData() {
+        sessions_.clear();
+        profiles_.clear();
+        dogs_to_delete_.clear();
+        crowded_.clear();
+        errors_.clear();
+    }
+
+    tick_profiler::TickProfiler::Report TickUseCase::GetProfile() const {
+        return profiler_.GetReport();
+    }
+
+    RecordsUseCase::RecordsUseCase(const model::RetiredDogRepository& retired_dogs)
+        : retired_dogs_(retired_dogs)
     {}
 
     const std::vector<model::RetiredDog> RecordsUseCase::GetRecords(int offset, int max_elements) const {
-       return game_db_.GetRetiredDogs(offset, max_elements);
+       return retired_dogs_.LoadDataFromDB(offset, max_elements);
     }
 
-    Application::Application(model::Game& game, const postgres::AppConfig& config)
+    Application::Application(model::Game& game, model::RetiredDogRepository& retired_dogs)
         : game_(game)
-        , game_db_(config) 
         , list_maps_(game)
         , find_map_(game)
         , join_game_(game, players_, tokens_)
         , list_players_(game, players_, tokens_)
         , game_state_(game, players_, tokens_)
         , action_move_(game, players_, tokens_)
-        , tick_(game, game_db_)
-        , records_(game_db_)
+        , tick_(game, retired_dogs)
+        , records_(retired_dogs)
     {}
 
     void Application::SetListener(ApplicationListener& listener) {
@@ -434,6 +533,34 @@ namespace app {
         }
     }
 
+    void Application::SetTickThreads(unsigned threads) {
+        tick_.SetThreads(threads);
+    }
+
+    tick_profiler::TickProfiler::Report Application::TickProfile() const {
+        return tick_.GetProfile();
+    }
+
+    void Application::SetTickBudget(std::chrono::milliseconds budget) {
+        tick_.SetBudget(budget);
+    }
+
+    tick_budget::Level Application::GetDegradationLevel() const {
+        return tick_.GetDegradationLevel();
+    }
+
+    void Application::FlushRetiredDogs() {
+        tick_.FlushRetiredDogs();
+    }
+
+    size_t Application::GetTickCount() const {
+        return tick_.GetTickCount();
+    }
+
+    std::uint64_t Application::GetChecksum() const {
+        return game_.GetChecksum();
+    }
+
     void Application::Tick(std::chrono::milliseconds delta) {
         tick_.Tick(delta);     
         if(listener_){ 
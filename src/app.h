@@ -2,13 +2,20 @@
 #include "model.h"
 #include "json_loader.h"
 #include "collision_detector.h"
-#include "postgres.h"
+#include "retired_dogs.h"
+#include "tick_profiler.h"
+#include "tick_budget.h"
 
-#include <set>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
+
+#include <span>
+#include <latch>
+#include <memory_resource>
 #include <iostream>
 #include <random>
 #include <string_view>
-#include <pqxx/connection>
+#include <tuple>
 
 namespace detail {
     struct TokenTag {};
@@ -16,6 +23,7 @@ namespace detail {
 
 namespace app {
 
+    namespace net = boost::asio;
     using namespace std::literals;  
  
     class Player {
@@ -78,20 +86,6 @@ namespace app {
         app::PlayerTokens& tokens_;
     };
 
-    class LostObjDogProvider : public collision_detector::ItemGathererProvider {
-    public:
-        explicit LostObjDogProvider(const std::vector<collision_detector::Item>& items,
-                                const std::vector<collision_detector::Gatherer>& gatherers);
-     
-        size_t ItemsCount() const override;
-        collision_detector::Item GetItem(size_t idx) const override;
-        size_t GatherersCount() const override;
-        collision_detector::Gatherer GetGatherer(size_t idx) const override;
-    private:
-        std::vector<collision_detector::Item> items_;
-        std::vector<collision_detector::Gatherer> gatherers_;
-    };
-
     class ListMapsUseCase {
     public:
         explicit ListMapsUseCase(const model::Game& game);
@@ -139,8 +133,7 @@ namespace app {
     public:
         explicit GetStateUseCase(const model::Game& game, const Players& players, const PlayerTokens& tokens);
         struct GameStateResult {
-            const model::GameSession::Dogs& dogs;
-            const model::GameSession::LostObjects& lost_objects;
+            std::shared_ptr<const model::GameSession::Snapshot> snapshot;
         };
         const GameStateResult State(const Token& token) const;
     private:
@@ -161,31 +154,60 @@ namespace app {
 
     class TickUseCase {
     public:
-        explicit TickUseCase(model::Game& game, postgres::DataBase& game_db);
+        explicit TickUseCase(model::Game& game, model::RetiredDogRepository& retired_dogs);
+        void SetThreads(unsigned threads);
         void Tick(std::chrono::milliseconds delta);
+        tick_profiler::TickProfiler::Report GetProfile() const;
+        void SetBudget(std::chrono::milliseconds budget);
+        void SetDegradationLevel(tick_budget::Level level);
+        tick_budget::Level GetDegradationLevel() const;
+        void FlushRetiredDogs();
+        size_t GetTickCount() const;
     private:
-        bool IsPosBelongToRoad(const model::Position& pos, const model::FieldRoad& field_road);
-        std::vector<model::FieldRoad> GetContainRoads(const model::Map map, const model::Position& pos);
-        model::Position MakeMove(std::shared_ptr<model::Dog> dog, const std::vector<model::FieldRoad>& roads, 
-                                        model::Position new_pos, model::Position mid_pos);
-        double FindNearestPoint(double axis_point_l, double  axis_point_b, double mid_point, double new_point);
-        std::vector<collision_detector::Gatherer> MakeGatherersData(const model::Map& map, model::GameSession::Dogs& dogs, 
-                                                                                          std::chrono::milliseconds delta);
-        static std::vector<collision_detector::Item> MakeItemsData(const model::Map& map, const model::GameSession::LostObjects& lost_objects);
-
-        std::set<int> ExecuteActionEvents(std::vector<collision_detector::GatheringEvent>& dog_events, 
-                                                        std::shared_ptr<model::GameSession> session, LostObjDogProvider& prov);
+        using DogsToDelete = std::pmr::vector<std::pair<int, std::chrono::milliseconds>>;
+
+        constexpr static size_t REDUCED_LOOT_STRIDE = 4;
+
+        template <typename Fn>
+        void ParallelFor(size_t count, Fn&& fn);
+        template <typename Fn>
+        void ForEachSession(Fn&& fn);
+        // Crowded sessions search collisions on all workers
+        collision_detector::Parallelism GetGatherParallelism(size_t index) const;
+        void TickSession(size_t index, std::chrono::milliseconds delta);
+        void ClearTickData();
+        std::pmr::vector<collision_detector::Gatherer> MakeGatherersData(const model::Map& map, model::GameSession& session, 
+                                                        std::chrono::milliseconds delta, std::pmr::memory_resource* resource);
+        // Replays pickups and deliveries in the order of time, pickups first on a tie.
+        // Returns the collected lost objects.
+        std::pmr::vector<model::GameSession::LootHandle> ExecuteActionEvents(const std::pmr::vector<collision_detector::GatheringEvent>& loot_events, 
+                                const std::pmr::vector<collision_detector::GatheringEvent>& office_events,
+                                std::shared_ptr<model::GameSession> session, std::pmr::memory_resource* resource);
 
         model::Game* game_;
-        postgres::DataBase& game_db_;
+        model::RetiredDogRepository& retired_dogs_repository_;
+        std::unique_ptr<net::thread_pool> workers_;
+        unsigned threads_ = 1;
+        collision_detector::ParallelFor gather_parallel_for_;
+        tick_profiler::TickProfiler profiler_;
+        tick_budget::TickBudget budget_;
+        tick_budget::Level level_ = tick_budget::Level::NORMAL;
+        size_t tick_count_ = 0;
+
+        std::vector<std::pair<const model::Map*, std::shared_ptr<model::GameSession>>> sessions_;
+        std::vector<tick_profiler::MapProfile*> profiles_;
+        std::vector<DogsToDelete> dogs_to_delete_;
+        std::vector<uint8_t> crowded_;
+        std::vector<std::exception_ptr> errors_;
+        std::vector<std::pair<tick_profiler::MapProfile*, model::ToRetiredDogInfo>> retired_dogs_;
     };
 
     class RecordsUseCase {
     public:
-        explicit RecordsUseCase(const postgres::DataBase& game_db);
+        explicit RecordsUseCase(const model::RetiredDogRepository& retired_dogs);
         const std::vector<model::RetiredDog> GetRecords(int offset, int max_elements) const;
     private:
-        const postgres::DataBase& game_db_;
+        const model::RetiredDogRepository& retired_dogs_;
     };
 
     class Application;
@@ -197,7 +219,7 @@ namespace app {
 
     class Application {
     public:
-        explicit Application(model::Game& game, const postgres::AppConfig& config);
+        explicit Application(model::Game& game, model::RetiredDogRepository& retired_dogs);
 
         void SetListener(ApplicationListener& listener);
         model::Game& GetGame();
@@ -210,14 +232,20 @@ namespace app {
         const model::GameSession::Dogs& ListPlayers(const Token& token) const;
         const GetStateUseCase::GameStateResult GameState(const Token& token) const;
         void ActionMove(const Token& token, const std::string& dir);
+        void SetTickThreads(unsigned threads);
         void Tick(std::chrono::milliseconds delta);
+        tick_profiler::TickProfiler::Report TickProfile() const;
+        void SetTickBudget(std::chrono::milliseconds budget);
+        tick_budget::Level GetDegradationLevel() const;
+        void FlushRetiredDogs();
+        size_t GetTickCount() const;
+        std::uint64_t GetChecksum() const;
         const std::vector<model::RetiredDog> Records(int offset, int max_elements) const;
 
     private:
         model::Game& game_;
         Players players_;
         PlayerTokens tokens_;
-        postgres::DataBase game_db_;
 
         ListMapsUseCase list_maps_;
         FindMapUseCase find_map_;
@@ -6,14 +6,17 @@ namespace serialization {
     using namespace std::literals;
 
     void AppSerialization(const std::filesystem::path& file_serialize, app::Application& app) {
+        SaveApplicationRepr(file_serialize, ApplicationRepr{app});
+    }
+
+    void SaveApplicationRepr(const std::filesystem::path& file_serialize, const ApplicationRepr& app_repr) {
         auto temp_serialize = file_serialize.parent_path();
         temp_serialize  += ("/temp_file");
-
-        std::ofstream out(temp_serialize , std::ios_base::binary);
-        boost::archive::text_oarchive output{out};
-        ApplicationRepr app_repr{app};
-        output << app_repr;
-
+        {
+            std::ofstream out(temp_serialize , std::ios_base::binary);
+            boost::archive::text_oarchive output{out};
+            output << app_repr;
+        }
         std::filesystem::rename(temp_serialize , file_serialize);
     }
 
@@ -91,6 +91,7 @@ namespace serialization {
     };
 
     void AppSerialization(const std::filesystem::path& file_serialize, app::Application& app);
+    void SaveApplicationRepr(const std::filesystem::path& file_serialize, const ApplicationRepr& app_repr);
     void AppDeserialization(const std::filesystem::path& file_serialize, app::Application& app);
     
 } // namespace serialization
\ No newline at end of file
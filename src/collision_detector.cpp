@@ -1,8 +1,191 @@
 #include "collision_detector.h"
+#include "collision_kernel.h"
+#include "spatial_hash.h"
+
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
 
 namespace collision_detector {
 
+    namespace {
+
+        bool EventLess(const GatheringEvent& lhs, const GatheringEvent& rhs) {
+            if(lhs.time != rhs.time){
+                return lhs.time < rhs.time;
+            }
+            if(lhs.gatherer_id != rhs.gatherer_id){
+                return lhs.gatherer_id < rhs.gatherer_id;
+            }
+            return lhs.item_id < rhs.item_id;
+        }
+
+        constexpr size_t BUCKET_SORT_MIN = 64;
+
+        // Counting sort into as many buckets of time as there are events, then EventLess inside
+        // the buckets. Time of a collected item is in [0, 1] and rounding keeps t * n monotonic,
+        // so the order is exactly the one of std::sort with EventLess in expected linear time.
+        void SortEvents(std::pmr::vector<GatheringEvent>& events) {
+            if(events.size() < BUCKET_SORT_MIN){
+                std::sort(events.begin(), events.end(), EventLess);
+                return;
+            }
+            const size_t buckets = events.size();
+            auto bucket_of = [buckets](double time){
+                return std::min(buckets - 1, static_cast<size_t>(std::clamp(time, 0., 1.) * buckets));
+            };
+            std::pmr::vector<size_t> starts(buckets + 1, 0, events.get_allocator());
+            for(const auto& event : events){
+                ++starts[bucket_of(event.time) + 1];
+            }
+            for(size_t i = 1; i <= buckets; i++){
+                starts[i] += starts[i - 1];
+            }
+            std::pmr::vector<GatheringEvent> sorted(events.size(), events.get_allocator());
+            std::pmr::vector<size_t> next(starts.begin(), starts.end() - 1, events.get_allocator());
+            for(const auto& event : events){
+                sorted[next[bucket_of(event.time)]++] = event;
+            }
+            for(size_t i = 0; i < buckets; i++){
+                if(starts[i + 1] - starts[i] > 1){
+                    std::sort(sorted.begin() + starts[i], sorted.begin() + starts[i + 1], EventLess);
+                }
+            }
+            events.swap(sorted);
+        }
+
+        bool IsMoving(const Gatherer& gatherer) {
+            return gatherer.start_pos.x != gatherer.end_pos.x || gatherer.start_pos.y != gatherer.end_pos.y;
+        }
+
+        // Items are bucketed by cell in a sorted array; every gatherer scans the cells
+        // of its path's bounding box grown by the largest possible gather radius.
+        class UniformGrid {
+        public:
+            UniformGrid(std::span<const Item> items, double max_gatherer_width, std::pmr::memory_resource* resource)
+                : cells_{resource}
+                , columns_{resource} {
+                double max_item_width = 0;
+                for(const auto& item : items){
+                    max_item_width = std::max(max_item_width, item.width);
+                }
+                reach_ = max_gatherer_width + max_item_width;
+                cell_size_ = reach_ > 0 ? reach_ : 1.;
+
+                std::pmr::vector<std::pair<uint64_t, size_t>> entries{resource};
+                entries.reserve(items.size());
+                for(size_t j = 0; j < items.size(); j++){
+                    entries.emplace_back(CellKey(Cell(items[j].position.x), Cell(items[j].position.y)), j);
+                }
+                std::sort(entries.begin(), entries.end());
+                cells_.reserve(entries.size());
+                columns_.Reserve(entries.size());
+                for(const auto& [cell, item_id] : entries){
+                    cells_.push_back(cell);
+                    columns_.Add(item_id, items[item_id]);
+                }
+            }
+
+            void Find(const Gatherer& gatherer, std::pmr::vector<GatheringEvent>& result) const {
+                const int64_t x0 = Cell(std::min(gatherer.start_pos.x, gatherer.end_pos.x) - reach_);
+                const int64_t x1 = Cell(std::max(gatherer.start_pos.x, gatherer.end_pos.x) + reach_);
+                const int64_t y0 = Cell(std::min(gatherer.start_pos.y, gatherer.end_pos.y) - reach_);
+                const int64_t y1 = Cell(std::max(gatherer.start_pos.y, gatherer.end_pos.y) + reach_);
+                if(static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1) > static_cast<double>(cells_.size())){
+                    GatherRange(gatherer, columns_, 0, columns_.Size(), result);
+                    return;
+                }
+                for(int64_t x = x0; x <= x1; x++){
+                    // cells of one column are adjacent in the sorted array
+                    auto first = std::lower_bound(cells_.begin(), cells_.end(), CellKey(x, y0));
+                    auto last = std::upper_bound(first, cells_.end(), CellKey(x, y1));
+                    GatherRange(gatherer, columns_, first - cells_.begin(), last - cells_.begin(), result);
+                }
+            }
+
+        private:
+            int64_t Cell(double coord) const {
+                return static_cast<int64_t>(std::floor(coord / cell_size_));
+            }
+
+            std::pmr::vector<uint64_t> cells_;
+            ItemColumns columns_;
+            double reach_ = 0;
+            double cell_size_ = 1.;
+        };
+
+        double MaxMovingWidth(std::span<const Gatherer> gatherers) {
+            double max_width = -1;
+            for(const auto& gatherer : gatherers) {
+                if(IsMoving(gatherer)){
+                    max_width = std::max(max_width, gatherer.width);
+                }
+            }
+            return max_width;
+        }
+
+        void MergeSorted(const std::pmr::vector<std::pmr::vector<GatheringEvent>>& parts, std::pmr::vector<GatheringEvent>& result) {
+            using Head = std::pair<const GatheringEvent*, const GatheringEvent*>;
+            std::pmr::vector<Head> heads{result.get_allocator()};
+            size_t total = 0;
+            for(const auto& part : parts){
+                total += part.size();
+                if(!part.empty()){
+                    heads.emplace_back(part.data(), part.data() + part.size());
+                }
+            }
+            result.reserve(total);
+            auto greater = [](const Head& lhs, const Head& rhs){
+                return EventLess(*rhs.first, *lhs.first);
+            };
+            std::make_heap(heads.begin(), heads.end(), greater);
+            while(!heads.empty()){
+                std::pop_heap(heads.begin(), heads.end(), greater);
+                auto& head = heads.back();
+                result.push_back(*head.first++);
+                if(head.first == head.second){
+                    heads.pop_back();
+                }
+                else {
+                    std::push_heap(heads.begin(), heads.end(), greater);
+                }
+            }
+        }
+
+        // Sorted events of the moving gatherers; find(gatherer, events) must be safe to call concurrently
+        template <typename Find>
+        std::pmr::vector<GatheringEvent> Gather(std::span<const Gatherer> gatherers, const Parallelism& parallelism,
+                                                std::pmr::memory_resource* resource, const Find& find) {
+            auto gather_part = [&find](std::span<const Gatherer> part, std::pmr::vector<GatheringEvent>& events){
+                for(const auto& gatherer : part){
+                    if(IsMoving(gatherer)){
+                        find(gatherer, events);
+                    }
+                }
+                SortEvents(events);
+            };
+            std::pmr::vector<GatheringEvent> result{resource};
+            const size_t chunks = std::min(parallelism.chunks, gatherers.size());
+            if(!parallelism.parallel_for || chunks < 2 || gatherers.size() < PARALLEL_MIN_GATHERERS){
+                gather_part(gatherers, result);
+                return result;
+            }
+            // resource may be an arena that is not thread-safe; the pool serializes access to it
+            std::pmr::synchronized_pool_resource pool{resource};
+            std::pmr::vector<std::pmr::vector<GatheringEvent>> parts{&pool};
+            parts.resize(chunks);
+            (*parallelism.parallel_for)(chunks, [&](size_t chunk){
+                const size_t begin = gatherers.size() * chunk / chunks;
+                const size_t end = gatherers.size() * (chunk + 1) / chunks;
+                gather_part(gatherers.subspan(begin, end - begin), parts[chunk]);
+            });
+            MergeSorted(parts, result);
+            return result;
+        }
+
+    }  // namespace
 
     CollectionResult TryCollectPoint(geom::Point2D a, geom::Point2D b, geom::Point2D c) {
         const double u_x = c.x - a.x;
@@ -19,26 +202,53 @@ namespace collision_detector {
     }
 
 
-    std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider) {
-        std::vector<GatheringEvent> result;
-
-        for(size_t i = 0; i < provider.GatherersCount(); i ++) {
-            auto gatherer = provider.GetGatherer(i);
-            if(gatherer.start_pos.x == gatherer.end_pos.x && gatherer.start_pos.y == gatherer.end_pos.y){
-                continue;
-            }
-            for(size_t j = 0; j < provider.ItemsCount(); j ++) { 
-                auto item = provider.GetItem(j);
-                auto coll_res = TryCollectPoint(gatherer.start_pos, gatherer.end_pos, item.position);
-                if(coll_res.IsCollected(gatherer.width + item.width)){
-                    result.push_back({j, gatherer.id, coll_res.sq_distance, coll_res.proj_ratio}); // здесь поменяли
-                }
+    std::pmr::vector<GatheringEvent> FindGatherEvents(std::span<const Item> items, std::span<const Gatherer> gatherers,
+                                                      std::pmr::memory_resource* resource, BroadPhase broad_phase,
+                                                      const Parallelism& parallelism) {
+        if(broad_phase == BroadPhase::AUTO){
+            const bool many_pairs = gatherers.size() * items.size() >= GRID_MIN_PAIRS;
+            broad_phase = many_pairs ? BroadPhase::UNIFORM_GRID : BroadPhase::NONE;
+        }
+        if(broad_phase == BroadPhase::UNIFORM_GRID){
+            const double max_gatherer_width = MaxMovingWidth(gatherers);
+            if(max_gatherer_width < 0){
+                return std::pmr::vector<GatheringEvent>{resource};
             }
+            UniformGrid grid{items, max_gatherer_width, resource};
+            return Gather(gatherers, parallelism, resource, [&grid](const Gatherer& gatherer, auto& events){
+                grid.Find(gatherer, events);
+            });
+        }
+        ItemColumns columns{resource};
+        columns.Reserve(items.size());
+        for(size_t j = 0; j < items.size(); j ++) { 
+            columns.Add(j, items[j]);
         }
-        std::sort(result.begin(), result.end(), [](GatheringEvent& lhs, GatheringEvent& rhs){
-            return lhs.time < rhs.time;
+        return Gather(gatherers, parallelism, resource, [&columns](const Gatherer& gatherer, auto& events){
+            GatherRange(gatherer, columns, 0, columns.Size(), events);
+        });
+    }
+
+    std::pmr::vector<GatheringEvent> FindGatherEvents(const SpatialHash& items, std::span<const Gatherer> gatherers,
+                                                      std::pmr::memory_resource* resource, const Parallelism& parallelism) {
+        return Gather(gatherers, parallelism, resource, [&items](const Gatherer& gatherer, auto& events){
+            items.Find(gatherer, events);
         });
-        return result;
+    }
+
+    std::pmr::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider, std::pmr::memory_resource* resource,
+                                                                                                    BroadPhase broad_phase) {
+        std::pmr::vector<Item> items{resource};
+        items.reserve(provider.ItemsCount());
+        for(size_t j = 0; j < provider.ItemsCount(); j ++) {
+            items.push_back(provider.GetItem(j));
+        }
+        std::pmr::vector<Gatherer> gatherers{resource};
+        gatherers.reserve(provider.GatherersCount());
+        for(size_t i = 0; i < provider.GatherersCount(); i ++) {
+            gatherers.push_back(provider.GetGatherer(i));
+        }
+        return FindGatherEvents(items, gatherers, resource, broad_phase);
     }
 
 
@@ -3,6 +3,9 @@
 #include "geom.h"
 
 #include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <span>
 #include <vector>
 
 namespace collision_detector {
@@ -48,6 +51,40 @@ namespace collision_detector {
         double time;
     };
 
-    std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider);
+    // AUTO uses the uniform grid once there are enough gatherer-item pairs for it to pay off.
+    // Both paths produce the same events in the same order: by time, then gatherer id, then item id.
+    enum class BroadPhase { AUTO, NONE, UNIFORM_GRID };
+
+    constexpr size_t GRID_MIN_PAIRS = 4096;
+
+    // Runs job(0) ... job(count - 1), possibly concurrently, and returns when all of them are done
+    using ParallelFor = std::function<void(size_t count, const std::function<void(size_t)>& job)>;
+
+    // Gatherers are split into chunks searched by parallel_for; the chunks' sorted events are
+    // merged, so the result is the same as the sequential one. Smaller inputs are searched inline.
+    struct Parallelism {
+        const ParallelFor* parallel_for = nullptr;
+        size_t chunks = 1;
+    };
+
+    constexpr size_t PARALLEL_MIN_GATHERERS = 512;
+
+    // item_id of an event is the index in items, gatherer_id is copied from the gatherer
+    std::pmr::vector<GatheringEvent> FindGatherEvents(std::span<const Item> items, std::span<const Gatherer> gatherers,
+                                                      std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                                      BroadPhase broad_phase = BroadPhase::AUTO,
+                                                      const Parallelism& parallelism = {});
+
+    class SpatialHash;
+
+    // Queries a persistent index instead of building a broad phase for the call
+    std::pmr::vector<GatheringEvent> FindGatherEvents(const SpatialHash& items, std::span<const Gatherer> gatherers,
+                                                      std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                                      const Parallelism& parallelism = {});
+
+    // Adapter for providers: copies the input once and runs the span overload
+    std::pmr::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider, 
+                                                      std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                                      BroadPhase broad_phase = BroadPhase::AUTO);
 
 }  // namespace collision_detector
\ No newline at end of file
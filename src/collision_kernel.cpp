@@ -0,0 +1,149 @@
+#include "collision_kernel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COLLISION_KERNEL_X86
+#endif
+
+namespace collision_detector {
+
+    namespace {
+
+        using Kernel = std::uint64_t (*)(const Gatherer&, ItemBatch, double*, double*);
+
+        std::uint64_t CollectScalar(const Gatherer& gatherer, ItemBatch items, double* proj_ratio, double* sq_distance) {
+            const double v_x = gatherer.end_pos.x - gatherer.start_pos.x;
+            const double v_y = gatherer.end_pos.y - gatherer.start_pos.y;
+            const double v_len2 = v_x * v_x + v_y * v_y;
+            std::uint64_t mask = 0;
+            for(size_t i = 0; i < items.count; i++){
+                const double u_x = items.x[i] - gatherer.start_pos.x;
+                const double u_y = items.y[i] - gatherer.start_pos.y;
+                const double u_dot_v = u_x * v_x + u_y * v_y;
+                const double u_len2 = u_x * u_x + u_y * u_y;
+                proj_ratio[i] = u_dot_v / v_len2;
+                sq_distance[i] = u_len2 - (u_dot_v * u_dot_v) / v_len2;
+                if(CollectionResult{sq_distance[i], proj_ratio[i]}.IsCollected(gatherer.width + items.width[i])){
+                    mask |= std::uint64_t{1} << i;
+                }
+            }
+            return mask;
+        }
+
+#ifdef COLLISION_KERNEL_X86
+        __attribute__((target("avx2")))
+        std::uint64_t CollectAvx2(const Gatherer& gatherer, ItemBatch items, double* proj_ratio, double* sq_distance) {
+            const double v_x = gatherer.end_pos.x - gatherer.start_pos.x;
+            const double v_y = gatherer.end_pos.y - gatherer.start_pos.y;
+            const __m256d a_x = _mm256_set1_pd(gatherer.start_pos.x);
+            const __m256d a_y = _mm256_set1_pd(gatherer.start_pos.y);
+            const __m256d v_x_v = _mm256_set1_pd(v_x);
+            const __m256d v_y_v = _mm256_set1_pd(v_y);
+            const __m256d v_len2 = _mm256_set1_pd(v_x * v_x + v_y * v_y);
+            const __m256d gatherer_width = _mm256_set1_pd(gatherer.width);
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d one = _mm256_set1_pd(1.);
+            std::uint64_t mask = 0;
+            size_t i = 0;
+            for(; i + 4 <= items.count; i += 4){
+                const __m256d u_x = _mm256_sub_pd(_mm256_loadu_pd(items.x + i), a_x);
+                const __m256d u_y = _mm256_sub_pd(_mm256_loadu_pd(items.y + i), a_y);
+                const __m256d u_dot_v = _mm256_add_pd(_mm256_mul_pd(u_x, v_x_v), _mm256_mul_pd(u_y, v_y_v));
+                const __m256d u_len2 = _mm256_add_pd(_mm256_mul_pd(u_x, u_x), _mm256_mul_pd(u_y, u_y));
+                const __m256d proj = _mm256_div_pd(u_dot_v, v_len2);
+                const __m256d sq = _mm256_sub_pd(u_len2, _mm256_div_pd(_mm256_mul_pd(u_dot_v, u_dot_v), v_len2));
+                const __m256d radius = _mm256_add_pd(gatherer_width, _mm256_loadu_pd(items.width + i));
+                const __m256d hit = _mm256_and_pd(
+                    _mm256_and_pd(_mm256_cmp_pd(proj, zero, _CMP_GE_OQ), _mm256_cmp_pd(proj, one, _CMP_LE_OQ)),
+                    _mm256_cmp_pd(sq, _mm256_mul_pd(radius, radius), _CMP_LE_OQ));
+                _mm256_storeu_pd(proj_ratio + i, proj);
+                _mm256_storeu_pd(sq_distance + i, sq);
+                mask |= static_cast<std::uint64_t>(_mm256_movemask_pd(hit)) << i;
+            }
+            if(i < items.count){
+                ItemBatch tail{items.x + i, items.y + i, items.width + i, items.count - i};
+                mask |= CollectScalar(gatherer, tail, proj_ratio + i, sq_distance + i) << i;
+            }
+            return mask;
+        }
+#endif
+
+        struct KernelInfo {
+            Kernel kernel;
+            const char* name;
+        };
+
+        KernelInfo SelectKernel() {
+#ifdef COLLISION_KERNEL_X86
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2")){
+                return {CollectAvx2, "avx2"};
+            }
+#endif
+            return {CollectScalar, "scalar"};
+        }
+
+        const KernelInfo& GetKernel() {
+            static const KernelInfo kernel = SelectKernel();
+            return kernel;
+        }
+
+    }  // namespace
+
+    std::uint64_t CollectBatch(const Gatherer& gatherer, ItemBatch items, double* proj_ratio, double* sq_distance) {
+        assert(items.count <= BATCH_SIZE);
+        return GetKernel().kernel(gatherer, items, proj_ratio, sq_distance);
+    }
+
+    const char* GetKernelName() {
+        return GetKernel().name;
+    }
+
+    void ItemColumns::Reserve(size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+        width.reserve(count);
+        id.reserve(count);
+    }
+
+    void ItemColumns::Add(size_t item_id, const Item& item) {
+        x.push_back(item.position.x);
+        y.push_back(item.position.y);
+        width.push_back(item.width);
+        id.push_back(item_id);
+    }
+
+    void ItemColumns::SwapRemove(size_t pos) {
+        x[pos] = x.back();
+        y[pos] = y.back();
+        width[pos] = width.back();
+        id[pos] = id.back();
+        x.pop_back();
+        y.pop_back();
+        width.pop_back();
+        id.pop_back();
+    }
+
+    size_t ItemColumns::Size() const {
+        return id.size();
+    }
+
+    void GatherRange(const Gatherer& gatherer, const ItemColumns& items, size_t begin, size_t end, 
+                     std::pmr::vector<GatheringEvent>& result) {
+        double proj_ratio[BATCH_SIZE];
+        double sq_distance[BATCH_SIZE];
+        for(size_t first = begin; first < end; first += BATCH_SIZE){
+            ItemBatch batch{items.x.data() + first, items.y.data() + first, items.width.data() + first, 
+                            std::min(BATCH_SIZE, end - first)};
+            for(auto hits = CollectBatch(gatherer, batch, proj_ratio, sq_distance); hits; hits &= hits - 1){
+                const size_t i = std::countr_zero(hits);
+                result.push_back({items.id[first + i], gatherer.id, sq_distance[i], proj_ratio[i]});
+            }
+        }
+    }
+
+}  // namespace collision_detector
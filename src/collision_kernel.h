@@ -0,0 +1,52 @@
+#pragma once
+
+#include "collision_detector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace collision_detector {
+
+    constexpr size_t BATCH_SIZE = 64;
+
+    // Structure-of-arrays block of at most BATCH_SIZE items.
+    struct ItemBatch {
+        const double* x;
+        const double* y;
+        const double* width;
+        size_t count;
+    };
+
+    // Fills proj_ratio and sq_distance of every item against a moving gatherer and returns
+    // the mask of collected items, bit i for item i. The SIMD paths repeat the operations of
+    // TryCollectPoint in the same order without fusing them, so the tolerance against the
+    // scalar path is zero: results are bit-identical.
+    std::uint64_t CollectBatch(const Gatherer& gatherer, ItemBatch items, double* proj_ratio, double* sq_distance);
+
+    const char* GetKernelName();
+
+    // Items laid out for the batched kernel; id maps a column index back to the item index.
+    struct ItemColumns {
+        explicit ItemColumns(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : x{resource}, y{resource}, width{resource}, id{resource} {
+        }
+
+        void Reserve(size_t count);
+        void Add(size_t item_id, const Item& item);
+        // Moves the last column into pos
+        void SwapRemove(size_t pos);
+        size_t Size() const;
+
+        std::pmr::vector<double> x;
+        std::pmr::vector<double> y;
+        std::pmr::vector<double> width;
+        std::pmr::vector<size_t> id;
+    };
+
+    // Appends the events of a moving gatherer with the columns [begin, end)
+    void GatherRange(const Gatherer& gatherer, const ItemColumns& items, size_t begin, size_t end, 
+                     std::pmr::vector<GatheringEvent>& result);
+
+}  // namespace collision_detector
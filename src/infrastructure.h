@@ -3,6 +3,8 @@
 #include "app.h"
 #include "model.h"
 #include "app_serialization.h"
+#include <future>
+#include <memory>
 #include <string>
 
 
@@ -17,10 +19,15 @@ namespace insfrastruct {
             , time_since_save_(0ms)
         {}
 
+        // The state is captured on the tick strand, the archive is written in the background.
+        // A period that comes while the previous save is still running is postponed.
         void OnTick(std::chrono::milliseconds delta, app::Application& app) override {
             time_since_save_ += delta;
-            if(time_since_save_ >= save_period_){
-                serialization::AppSerialization(file_serialize_, app);           
+            if(time_since_save_ >= save_period_ && !IsSaving()){
+                auto app_repr = std::make_shared<const serialization::ApplicationRepr>(app);
+                saving_ = std::async(std::launch::async, [file = file_serialize_, app_repr] {
+                    serialization::SaveApplicationRepr(file, *app_repr);
+                });
                 time_since_save_ = 0ms;
             }
         }
@@ -29,7 +36,22 @@ namespace insfrastruct {
             file_serialize_ = file_name;
         }   
 
+        void Wait() {
+            if(saving_.valid()){
+                saving_.get();
+            }
+        }
+
     private:
+        bool IsSaving() {
+            if(saving_.valid() && saving_.wait_for(0ms) == std::future_status::timeout){
+                return true;
+            }
+            Wait();
+            return false;
+        }
+
+        std::future<void> saving_;
         std::chrono::milliseconds time_since_save_ ;
         std::chrono::milliseconds save_period_;
         
@@ -160,4 +160,25 @@ namespace json_loader {
 		}
 		return loot_data;
 	}
+
+	json::value TickProfileToJson(const tick_profiler::TickProfiler::Report& report, tick_budget::Level level) {
+		constexpr double ns_to_us = 1e-3;
+		json::object maps;
+		for (const auto& [map_id, phases] : report) {
+			json::object map_phases;
+			for (size_t i = 0; i < tick_profiler::PHASE_COUNT; i++) {
+				const auto& summary = phases[i];
+				map_phases.emplace(tick_profiler::PHASE_NAMES[i], json::object{
+					{ "count", summary.count },
+					{ "p50", summary.p50 * ns_to_us },
+					{ "p90", summary.p90 * ns_to_us },
+					{ "p99", summary.p99 * ns_to_us },
+					{ "max", summary.max * ns_to_us } });
+			}
+			maps.emplace(map_id, std::move(map_phases));
+		}
+		return json::object{ { "unit", "us" }, 
+							 { "degradationLevel", tick_budget::LEVEL_NAMES[static_cast<size_t>(level)] }, 
+							 { "maps", std::move(maps) } };
+	}
 }  // namespace json_loader
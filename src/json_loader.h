@@ -5,6 +5,8 @@
 #include <fstream>
 #include "model.h"
 #include "extra_data.h"
+#include "tick_profiler.h"
+#include "tick_budget.h"
 
 namespace json = boost::json;
 
@@ -62,5 +64,6 @@ namespace json_loader {
 	std::string JsonAsString(const std::filesystem::path& json_path);
 	model::Game LoadGame(const std::filesystem::path& json_path);
 	extra_data::LootJsonData LoadLootData(const std::filesystem::path& json_path);
+	json::value TickProfileToJson(const tick_profiler::TickProfiler::Report& report, tick_budget::Level level);
 	
 }  // namespace json_loader
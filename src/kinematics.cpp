@@ -0,0 +1,79 @@
+#include "kinematics.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KINEMATICS_X86
+#endif
+
+namespace kinematics {
+
+    namespace {
+
+        using Kernel = void (*)(const double*, const double*, double, double, double*, size_t);
+
+        void IntegrateScalar(const double* pos, const double* speed, double time, double scale, double* out, size_t count) {
+            for(size_t i = 0; i < count; i++){
+                out[i] = pos[i] + speed[i] * time * scale;
+            }
+        }
+
+#ifdef KINEMATICS_X86
+        __attribute__((target("sse2")))
+        void IntegrateSse2(const double* pos, const double* speed, double time, double scale, double* out, size_t count) {
+            const __m128d time_v = _mm_set1_pd(time);
+            const __m128d scale_v = _mm_set1_pd(scale);
+            size_t i = 0;
+            for(; i + 2 <= count; i += 2){
+                __m128d step = _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(speed + i), time_v), scale_v);
+                _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(pos + i), step));
+            }
+            IntegrateScalar(pos + i, speed + i, time, scale, out + i, count - i);
+        }
+
+        __attribute__((target("avx2")))
+        void IntegrateAvx2(const double* pos, const double* speed, double time, double scale, double* out, size_t count) {
+            const __m256d time_v = _mm256_set1_pd(time);
+            const __m256d scale_v = _mm256_set1_pd(scale);
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4){
+                __m256d step = _mm256_mul_pd(_mm256_mul_pd(_mm256_loadu_pd(speed + i), time_v), scale_v);
+                _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(pos + i), step));
+            }
+            IntegrateSse2(pos + i, speed + i, time, scale, out + i, count - i);
+        }
+#endif
+
+        struct KernelInfo {
+            Kernel kernel;
+            const char* name;
+        };
+
+        KernelInfo SelectKernel() {
+#ifdef KINEMATICS_X86
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2")){
+                return {IntegrateAvx2, "avx2"};
+            }
+            if(__builtin_cpu_supports("sse2")){
+                return {IntegrateSse2, "sse2"};
+            }
+#endif
+            return {IntegrateScalar, "scalar"};
+        }
+
+        const KernelInfo& GetKernel() {
+            static const KernelInfo kernel = SelectKernel();
+            return kernel;
+        }
+
+    }  // namespace
+
+    void Integrate(const double* pos, const double* speed, double time, double scale, double* out, size_t count) {
+        GetKernel().kernel(pos, speed, time, scale, out, count);
+    }
+
+    const char* GetKernelName() {
+        return GetKernel().name;
+    }
+
+}  // namespace kinematics
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace kinematics {
+
+    // out[i] = pos[i] + speed[i] * time * scale, evaluated in this order so the
+    // SIMD and scalar paths give bit-identical results.
+    void Integrate(const double* pos, const double* speed, double time, double scale, double* out, size_t count);
+
+    const char* GetKernelName();
+
+}  // namespace kinematics
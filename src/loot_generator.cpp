@@ -9,6 +9,9 @@ namespace loot_gen {
                                     unsigned looter_count) {
         time_without_loot_ += time_delta;
         const unsigned loot_shortage = loot_count > looter_count ? 0u : looter_count - loot_count;
+        if (loot_shortage == 0) {
+            return 0;
+        }
         const double ratio = std::chrono::duration<double>{time_without_loot_} / base_interval_;
         const double probability
             = std::clamp((1.0 - std::pow(1.0 - probability_, ratio)) * random_generator_(), 0.0, 1.0);
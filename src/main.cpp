@@ -14,6 +14,7 @@
 #include "app.h"
 #include "extra_data.h"
 #include "ticker.h"
+#include "simulation_clock.h"
 #include "model_serialization.h"
 #include "infrastructure.h"
 #include "postgres.h"
@@ -39,11 +40,19 @@ namespace {
     struct Args {
         int tick_period;
         int save_state_period;
+        int sim_step;
+        int profile_log_period;
+        int tick_budget = 0;
+        std::uint64_t seed = 0;
+        int max_substeps = 5;
+        unsigned tick_threads = 1;
         std::string config_file;
         std::string static_dir;
         std::string state_file;
         bool ramdomize = false;
         bool without_state_file = false;
+        bool deterministic = false;
+        bool serve_tick_profile = false;
     }; 
 
     [[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
@@ -58,6 +67,13 @@ namespace {
             ("config-file,c", po::value(&args.config_file)->value_name("file"s), "set config path")
             ("www-root,w", po::value(&args.static_dir)->value_name("dir"s), "set static file root")
             ("state-file,f", po::value(&args.state_file)->value_name("file"s), "set state path")
+            ("tick-threads", po::value(&args.tick_threads)->value_name("threads"s), "set number of threads ticking game sessions")
+            ("sim-step", po::value(&args.sim_step)->value_name("milliseconds"s), "advance simulation in fixed steps")
+            ("max-substeps", po::value(&args.max_substeps)->value_name("steps"s), "set max simulation steps per tick")
+            ("profile-log-period", po::value(&args.profile_log_period)->value_name("milliseconds"s), "log tick profile periodically")
+            ("serve-tick-profile", "serve tick profile at /api/v1/admin/tick-profile")
+            ("tick-budget", po::value(&args.tick_budget)->value_name("milliseconds"s), "degrade tick work when ticks exceed the budget")
+            ("seed", po::value(&args.seed)->value_name("seed"s), "run deterministic simulation and log tick checksums")
             ("randomize-spawn-points", "spawn dogs at random positions");
 
         po::variables_map vm;
@@ -74,12 +90,27 @@ namespace {
         if(vm.contains("randomize-spawn-points")){
             args.ramdomize = true;
         }
+        if(vm.contains("seed")){
+            args.deterministic = true;
+        }
+        if(vm.contains("serve-tick-profile")){
+            args.serve_tick_profile = true;
+        }
         if(!vm.contains("save-state-period")){
             args.save_state_period = -1;
         }   
         if(!vm.contains("tick-period")){
             args.tick_period = -1;
         } 
+        if(!vm.contains("sim-step")){
+            args.sim_step = -1;
+        }
+        if(!vm.contains("profile-log-period")){
+            args.profile_log_period = -1;
+        }
+        if ((vm.contains("sim-step"s) || vm.contains("max-substeps"s)) && !vm.contains("tick-period"s)) {
+            throw std::runtime_error("Simulation step requires tick period"s);
+        }
         if (!vm.contains("config-file"s)) {
             throw std::runtime_error("Config file have not been specified"s);
         }
@@ -102,8 +133,14 @@ int main(int argc, const char* argv[]) {
             if(args->ramdomize){
                 game.SetRandomaizer();
             }
+            if(args->deterministic){
+                game.SetSeed(args->seed);
+            }
 
-            app::Application app{game, postgres::GetConfigFromEnv()}; 
+            postgres::DataBase game_db{postgres::GetConfigFromEnv()};
+            app::Application app{game, game_db.GetRetiredDogs()}; 
+            app.SetTickThreads(args->tick_threads);
+            app.SetTickBudget(std::chrono::milliseconds(args->tick_budget));
             
             insfrastruct::SerializationListener ser_lis(std::chrono::milliseconds(args->save_state_period)); 
 
@@ -130,15 +167,44 @@ int main(int argc, const char* argv[]) {
 
             bool accept_tick = true;
             if(args->tick_period != -1){
-                auto ticker = std::make_shared<ticker::Ticker>(api_strand, std::chrono::milliseconds(args->tick_period),
-                    [&app](std::chrono::milliseconds delta) { app.Tick(delta); }
-                );
+                ticker::Ticker::Handler on_tick = [&app](std::chrono::milliseconds delta) { app.Tick(delta); };
+                if(args->sim_step != -1){
+                    on_tick = [&app, sim_clock = ticker::SimulationClock{std::chrono::milliseconds(args->sim_step), args->max_substeps}]
+                                                                                    (std::chrono::milliseconds delta) mutable {
+                        auto advance = sim_clock.Add(delta);
+                        for(int i = 0; i < advance.steps; i++){
+                            app.Tick(sim_clock.GetStep());
+                        }
+                        if(advance.dropped.count() > 0){
+                            json::value dropped_data{{"dropped"s, advance.dropped.count()}, 
+                                                     {"total_dropped"s, sim_clock.GetTotalDropped().count()}};
+                            logger::LogInfo(dropped_data, "simulation time dropped"sv);
+                        }
+                    };
+                }
+                if(args->deterministic){
+                    on_tick = [&app, on_tick](std::chrono::milliseconds delta) {
+                        on_tick(delta);
+                        json::value checksum_data{{"tick"s, app.GetTickCount()}, {"checksum"s, app.GetChecksum()}};
+                        logger::LogInfo(checksum_data, "tick checksum"sv);
+                    };
+                }
+                auto ticker = std::make_shared<ticker::Ticker>(api_strand, std::chrono::milliseconds(args->tick_period), on_tick);
                 ticker->Start();
                 accept_tick  = false;
             }
 
+            if(args->profile_log_period != -1){
+                auto profile_logger = std::make_shared<ticker::Ticker>(api_strand, std::chrono::milliseconds(args->profile_log_period),
+                    [&app](std::chrono::milliseconds) { 
+                        logger::LogInfo(json_loader::TickProfileToJson(app.TickProfile(), app.GetDegradationLevel()), "tick profile"sv); 
+                    }
+                );
+                profile_logger->Start();
+            }
+
             auto handler = std::make_shared<http_handler::RequestHandler>(
-                static_files_root, api_strand, app, accept_tick, loot);
+                static_files_root, api_strand, app, accept_tick, loot, args->serve_tick_profile);
 
             http_handler::LoggingRequestHandler<http_handler::RequestHandler> log_handler{*handler, api_strand} ;
 
@@ -154,6 +220,8 @@ int main(int argc, const char* argv[]) {
             RunWorkers(std::max(1u, num_threads), [&ioc] {
                 ioc.run();
             });
+            app.FlushRetiredDogs();
+            ser_lis.Wait();
 
             if(!args->without_state_file){
                 serialization::AppSerialization(args->state_file, app);
@@ -1,11 +1,45 @@
 #include "model.h"
+#include "kinematics.h"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
 #include <stdexcept>
+#include <utility>
 
 namespace model {
 
     using namespace std::literals;
 
+    namespace {
+
+        FieldRoad MakeFieldRoad(const Road& road) {
+            const Point& start = road.GetStart();
+            const Point& end = road.GetEnd();
+            return {{std::min(start.x, end.x) - ObjectsWidth::ROAD_WIDTH, std::min(start.y, end.y) - ObjectsWidth::ROAD_WIDTH}, 
+                    {std::max(start.x, end.x) + ObjectsWidth::ROAD_WIDTH, std::max(start.y, end.y) + ObjectsWidth::ROAD_WIDTH}};
+        }
+
+        // splitmix64 finalizer over the running value; cheap and order sensitive
+        std::uint64_t HashCombine(std::uint64_t seed, std::uint64_t value) {
+            std::uint64_t x = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        // FNV-1a: unlike std::hash, the same on every platform and build
+        std::uint64_t StableHash(const std::string& str) {
+            std::uint64_t hash = 0xcbf29ce484222325ULL;
+            for(unsigned char c : str){
+                hash = (hash ^ c) * 0x100000001b3ULL;
+            }
+            return hash;
+        }
+
+    }  // namespace
+
     Road::Road(HorizontalTag, Point start, Coord end_x) noexcept
         : start_{ start }
         , end_{ end_x, start.y } {
@@ -79,6 +113,10 @@ namespace model {
         return roads_;
     }
 
+    const std::vector<collision_detector::Item>& Map::GetOfficeItems() const noexcept {
+        return office_items_;
+    }
+
     const Map::Offices& Map::GetOffices() const noexcept {
         return offices_;
     }
@@ -96,7 +134,54 @@ namespace model {
     }
 
     void Map::AddRoad(const Road& road) {
+        const size_t index = roads_.size();
         roads_.emplace_back(road);
+        const Point& start = road.GetStart();
+        const Point& end = road.GetEnd();
+        const double length = std::abs(end.x - start.x) + std::abs(end.y - start.y);
+        road_length_cdf_.push_back((road_length_cdf_.empty() ? 0. : road_length_cdf_.back()) + length);
+        if(road.IsHorizontal()){
+            road_index_.AddHorizontal(start.y, start.x, end.x, index);
+        }
+        else {
+            road_index_.AddVertical(start.x, start.y, end.y, index);
+        }
+    }
+
+    std::vector<FieldRoad> Map::FindContainRoads(const Position& pos) const {
+        std::vector<FieldRoad> contain_roads;
+        for(size_t index : road_index_.FindRoads({pos.x, pos.y})){
+            contain_roads.push_back(MakeFieldRoad(roads_[index]));
+        }
+        return contain_roads;
+    }
+
+    std::optional<road_index::Corridor> Map::FindCorridor(const Position& pos, road_index::Axis axis) const {
+        return road_index_.FindCorridor({pos.x, pos.y}, axis);
+    }
+
+    road_index::MoveResult Map::MoveAlongRoads(const Position& from, const Position& to, 
+                                                    std::optional<road_index::Corridor>& corridor) const {
+        return road_index_.Sweep({from.x, from.y}, {to.x, to.y}, corridor);
+    }
+
+    Position Map::PointAlongRoads(double share) const {
+        if(road_length_cdf_.empty()){
+            throw std::out_of_range("Map has no roads");
+        }
+        const double distance = share * road_length_cdf_.back();
+        auto it = std::upper_bound(road_length_cdf_.begin(), road_length_cdf_.end(), distance);
+        if(it == road_length_cdf_.end()){
+            --it;
+        }
+        const size_t index = it - road_length_cdf_.begin();
+        const double before = index == 0 ? 0. : road_length_cdf_[index - 1];
+        const Point& start = roads_[index].GetStart();
+        const Point& end = roads_[index].GetEnd();
+        const double offset = std::clamp(distance - before, 0., road_length_cdf_[index] - before);
+        const double dx = end.x > start.x ? offset : (end.x < start.x ? -offset : 0.);
+        const double dy = end.y > start.y ? offset : (end.y < start.y ? -offset : 0.);
+        return {start.x + dx, start.y + dy};
     }
 
     void Map::AddBuilding(const Building& building) {
@@ -111,7 +196,10 @@ namespace model {
         Office& o = offices_.emplace_back(office);
         try {
             warehouse_id_to_index_.emplace(o.GetId(), index);
+            const auto& pos = o.GetPosition();
+            office_items_.push_back({{static_cast<double>(pos.x), static_cast<double>(pos.y)}, ObjectsWidth::OFFICE_WIDTH});
         } catch (const std::exception& e) {
+            warehouse_id_to_index_.erase(o.GetId());
             offices_.pop_back();
             throw e;
         }
@@ -137,33 +225,173 @@ namespace model {
         return value_loots_;
     }
 
-    TimeChanger::TimeChanger(std::chrono::milliseconds time)
-            : accept_inaction_time_(time)
-            , all_time_(0ms)
-            , inaction_time_(0ms) 
-    {}           
+    DogKinematics::DogKinematics(const Position& pos, const Speed& speed)
+        : pos_(pos)
+        , speed_(speed)
+    {}
+
+    DogKinematics::DogKinematics(const DogKinematics& other)
+        : pos_(other.GetPosition())
+        , speed_(other.GetSpeed())
+    {}
+
+    DogKinematics& DogKinematics::operator=(const DogKinematics& other) {
+        if(this != &other){
+            SetPosition(other.GetPosition());
+            SetSpeed(other.GetSpeed());
+        }
+        return *this;
+    }
+
+    DogKinematics::~DogKinematics() {
+        Detach();
+    }
+
+    Position DogKinematics::GetPosition() const {
+        return buffer_ ? buffer_->positions_[slot_] : pos_;
+    }
+
+    Speed DogKinematics::GetSpeed() const {
+        return buffer_ ? buffer_->speeds_[slot_] : speed_;
+    }
 
-    std::optional<std::chrono::milliseconds> TimeChanger::TimerChange(std::chrono::milliseconds delta, bool inaction) {
-        all_time_+= delta;
-        if(inaction){
-            inaction_time_ += delta;
-            if(inaction_time_ >= accept_inaction_time_){
-                return all_time_;
+    bool DogKinematics::IsStopped() const {
+        if(buffer_){
+            return buffer_->stopped_[slot_];
+        }
+        return speed_.w == 0 && speed_.h == 0;
+    }
+
+    size_t DogKinematics::GetSlot() const {
+        return slot_;
+    }
+
+    void DogKinematics::SetPosition(const Position& pos) {
+        if(buffer_){
+            buffer_->positions_[slot_] = pos;
+        }
+        else {
+            pos_ = pos;
+        }
+    }
+
+    void DogKinematics::SetSpeed(const Speed& speed) {
+        if(buffer_){
+            const bool stopped = speed.w == 0 && speed.h == 0;
+            if(buffer_->stopped_[slot_] != stopped){
+                buffer_->moving_count_ += stopped ? -1 : 1;
             }
+            buffer_->speeds_[slot_] = speed;
+            buffer_->stopped_[slot_] = stopped;
         }
         else {
-            inaction_time_ = 0ms;
-        }      
-        return std::nullopt;
+            speed_ = speed;
+        }
+    }
+
+    void DogKinematics::Attach(KinematicsBuffer& buffer) {
+        if(buffer_ == &buffer){
+            return;
+        }
+        Detach();
+        slot_ = buffer.Add(this, pos_, speed_);
+        buffer_ = &buffer;
+    }
+
+    void DogKinematics::Detach() {
+        if(buffer_){
+            pos_ = buffer_->positions_[slot_];
+            speed_ = buffer_->speeds_[slot_];
+            buffer_->Remove(slot_);
+            buffer_ = nullptr;
+            slot_ = 0;
+        }
+    }
+
+    size_t KinematicsBuffer::Size() const {
+        return positions_.size();
+    }
+
+    size_t KinematicsBuffer::MovingCount() const {
+        return moving_count_;
+    }
+
+    const std::vector<Position>& KinematicsBuffer::Integrate(std::chrono::milliseconds delta) {
+        static_assert(sizeof(Position) == 2 * sizeof(double) && sizeof(Speed) == 2 * sizeof(double));
+        targets_.resize(positions_.size());
+        if(!positions_.empty()){
+            kinematics::Integrate(&positions_.front().x, &speeds_.front().w, static_cast<double>(delta.count()), 
+                                  ConvertValues::MS_TO_S, &targets_.front().x, 2 * positions_.size());
+        }
+        return targets_;
+    }
+
+    size_t KinematicsBuffer::Add(DogKinematics* owner, const Position& pos, const Speed& speed) {
+        positions_.push_back(pos);
+        speeds_.push_back(speed);
+        stopped_.push_back(speed.w == 0 && speed.h == 0);
+        owners_.push_back(owner);
+        moving_count_ += !stopped_.back();
+        return positions_.size() - 1;
+    }
+
+    void KinematicsBuffer::Remove(size_t slot) {
+        const size_t last = positions_.size() - 1;
+        moving_count_ -= !stopped_[slot];
+        if(slot != last){
+            positions_[slot] = positions_[last];
+            speeds_[slot] = speeds_[last];
+            stopped_[slot] = stopped_[last];
+            owners_[slot] = owners_[last];
+            owners_[slot]->slot_ = slot;
+        }
+        positions_.pop_back();
+        speeds_.pop_back();
+        stopped_.pop_back();
+        owners_.pop_back();
     }
 
     Dog::Dog(int id, const std::string& nickname, const Position& pos)
         : id_(id)
         , nickname_(nickname)
-        , pos_(pos)
-        , speed_{0, 0}
+        , kinematics_(pos, {0, 0})
+        , retirement_timer_(id)
     {}
 
+    Dog::Dog(const Dog& other)
+        : id_(other.id_)
+        , nickname_(other.nickname_)
+        , speed_value_(other.speed_value_)
+        , bag_capacity_(other.bag_capacity_)
+        , bag_content_(other.bag_content_)
+        , kinematics_(other.kinematics_)
+        , score_(other.score_)
+        , direction_(other.direction_)
+        , corridor_(other.corridor_)
+        , retirement_timer_(other.retirement_timer_)
+        , join_time_(other.join_time_)
+        , retirement_time_(other.retirement_time_)
+    {}
+
+    Dog& Dog::operator=(const Dog& other) {
+        if(this != &other){
+            DetachRetirement();
+            id_ = other.id_;
+            nickname_ = other.nickname_;
+            speed_value_ = other.speed_value_;
+            bag_capacity_ = other.bag_capacity_;
+            bag_content_ = other.bag_content_;
+            kinematics_ = other.kinematics_;
+            score_ = other.score_;
+            direction_ = other.direction_;
+            corridor_ = other.corridor_;
+            retirement_timer_ = other.retirement_timer_;
+            join_time_ = other.join_time_;
+            retirement_time_ = other.retirement_time_;
+        }
+        return *this;
+    }
+
     const std::string& Dog::GetDogName() const {
         return nickname_;
     }
@@ -172,16 +400,16 @@ namespace model {
         return id_;
     }
 
-    const Speed& Dog::GetSpeed() const {
-        return speed_;
+    Speed Dog::GetSpeed() const {
+        return kinematics_.GetSpeed();
     }
 
     const int Dog::GetBagCapacity() const {
         return bag_capacity_;
     }
 
-    const Position& Dog::GetPosition() const {
-        return pos_;
+    Position Dog::GetPosition() const {
+        return kinematics_.GetPosition();
     }
 
     const std::string& Dog::GetDirection() const {
@@ -195,6 +423,26 @@ namespace model {
         return score_;
     }
 
+    const std::optional<road_index::Corridor>& Dog::GetCorridor() const {
+        return corridor_;
+    }
+
+    void Dog::SetCorridor(const road_index::Corridor& corridor) {
+        corridor_ = corridor;
+    }
+
+    size_t Dog::GetKinematicsSlot() const {
+        return kinematics_.GetSlot();
+    }
+
+    void Dog::AttachKinematics(KinematicsBuffer& buffer) {
+        kinematics_.Attach(buffer);
+    }
+
+    void Dog::DetachKinematics() {
+        kinematics_.Detach();
+    }
+
     void Dog::SetSpeed(double speed) {
         speed_value_ = speed;
     }
@@ -205,6 +453,7 @@ namespace model {
     
     void Dog::SetBagCapacity(int capacity) {
         bag_capacity_ = capacity;
+        bag_content_.reserve(capacity);
     }
 
     void Dog::AddScore(int score) {
@@ -212,37 +461,39 @@ namespace model {
     }
     
     void Dog::ChangeDirection(const std::string& dir) {
-        if(listener_){
-            listener_->TimerChange(0ms, false);
-        }
+        corridor_.reset();
         if(dir == Direction::NORTH){
             direction_ = dir;
-            speed_ = {0, -1.0 * speed_value_};
+            kinematics_.SetSpeed({0, -1.0 * speed_value_});
         }
         if(dir == Direction::SOUTH){
             direction_ = dir;
-            speed_ = {0, speed_value_};
+            kinematics_.SetSpeed({0, speed_value_});
         }
         if(dir == Direction::WEST){
             direction_ = dir;
-            speed_ = {-1.0 * speed_value_, 0};
+            kinematics_.SetSpeed({-1.0 * speed_value_, 0});
         }
         if(dir == Direction::EAST){
             direction_ = dir;
-            speed_ = {speed_value_, 0};
+            kinematics_.SetSpeed({speed_value_, 0});
         }
         if(dir == ""){
-            speed_ = {0, 0};
+            kinematics_.SetSpeed({0, 0});
         }
+        RestartInactivity();
     }
 
     void Dog::StopMove() {
-        speed_.w = 0;
-        speed_.h = 0;
+        const bool was_moving = !IsStopped();
+        kinematics_.SetSpeed({0, 0});
+        if(was_moving){
+            RestartInactivity();
+        }
     }
 
     void Dog::ChangePosition(const Position& pos) {
-        pos_ = pos; 
+        kinematics_.SetPosition(pos);
     }
 
     bool Dog::PutInBag(const FindItem& item) {
@@ -257,25 +508,77 @@ namespace model {
         bag_content_.clear();
     }
 
-    void Dog::SetListener(std::chrono::milliseconds time) {
-        listener_ = std::make_shared<TimeChanger>(time);
+    void Dog::AttachRetirement(timing_wheel::TimingWheel& wheel, std::chrono::milliseconds retirement_time) {
+        retirement_wheel_ = &wheel;
+        retirement_time_ = retirement_time;
+        join_time_ = wheel.GetNow();
+        RestartInactivity();
     }
 
-    std::optional<std::chrono::milliseconds> Dog::InActiveDog(std::chrono::milliseconds delta) {
-        if(listener_){
-            return listener_->TimerChange(delta, DogIsStop());
+    void Dog::DetachRetirement() {
+        if(retirement_wheel_){
+            retirement_wheel_->Cancel(retirement_timer_);
+            retirement_wheel_ = nullptr;
         }
-        return std::nullopt;
     }
 
-    bool Dog::DogIsStop() {
-        return speed_.h == 0 && speed_.w == 0;
+    std::chrono::milliseconds Dog::GetPlayTime() const {
+        if(!retirement_wheel_){
+            return 0ms;
+        }
+        return std::chrono::milliseconds(retirement_wheel_->GetNow() - join_time_);
+    }
+
+    void Dog::RestartInactivity() {
+        if(!retirement_wheel_){
+            return;
+        }
+        if(IsStopped()){
+            const auto timeout = std::max(retirement_time_, 0ms);
+            retirement_wheel_->Schedule(retirement_timer_, retirement_wheel_->GetNow() + timeout.count());
+        }
+        else {
+            retirement_wheel_->Cancel(retirement_timer_);
+        }
+    }
+
+    bool Dog::IsStopped() const {
+        return kinematics_.IsStopped();
+    }
+
+    road_index::MoveResult MoveDog(const Map& map, Dog& dog, const Position& target) {
+        const Position from = dog.GetPosition();
+        auto corridor = dog.GetCorridor();
+        auto result = map.MoveAlongRoads(from, target, corridor);
+        if(corridor){
+            dog.SetCorridor(*corridor);
+        }
+        dog.ChangePosition({result.end.x, result.end.y});
+        if(result.blocked){
+            dog.StopMove();
+        }
+        return result;
     }
 
     GameSession::GameSession(const Map* map, LootGenData data) 
         : map_(map) 
-        , loot_gen_{std::chrono::milliseconds(static_cast<int>(data.period * ConvertValues::S_TO_MS)), data.probability}
-    {}
+        , loot_gen_{std::chrono::milliseconds(static_cast<int>(data.period * ConvertValues::S_TO_MS)), data.probability} {
+        // loot spawns on roads, so their cells are created before the first tick
+        for(const auto& road : map_->GetRoads()){
+            const Point& start = road.GetStart();
+            const Point& end = road.GetEnd();
+            loot_index_.ReserveArea({static_cast<double>(std::min(start.x, end.x)), static_cast<double>(std::min(start.y, end.y))},
+                                    {static_cast<double>(std::max(start.x, end.x)), static_cast<double>(std::max(start.y, end.y))},
+                                    LOOT_CELL_CAPACITY);
+        }
+    }
+
+    GameSession::~GameSession() {
+        for(auto& dog : dogs_){
+            dog.second->DetachKinematics();
+            dog.second->DetachRetirement();
+        }
+    }
   
     void GameSession::SetRandom() {
         random_points_ = true;
@@ -285,52 +588,127 @@ namespace model {
         retirement_time_ = time;
     }
 
+    void GameSession::AdvanceClock(std::chrono::milliseconds delta, std::pmr::vector<int>& inactive_dogs) {
+        retirement_wheel_.Advance(retirement_wheel_.GetNow() + delta.count(), inactive_dogs);
+    }
+
+    void GameSession::SetSeed(std::uint64_t seed) {
+        random_engine_.Seed(seed);
+    }
+
+    std::uint64_t GameSession::UpdateChecksum() {
+        std::uint64_t state = 0;
+        for(const auto& [id, dog] : dogs_){
+            state = HashCombine(state, static_cast<std::uint64_t>(id));
+            state = HashCombine(state, std::bit_cast<std::uint64_t>(dog->GetPosition().x));
+            state = HashCombine(state, std::bit_cast<std::uint64_t>(dog->GetPosition().y));
+            state = HashCombine(state, std::bit_cast<std::uint64_t>(dog->GetSpeed().w));
+            state = HashCombine(state, std::bit_cast<std::uint64_t>(dog->GetSpeed().h));
+            state = HashCombine(state, static_cast<std::uint64_t>(dog->GetScore()));
+            for(const auto& item : dog->GetBagContent()){
+                state = HashCombine(state, static_cast<std::uint64_t>(item.id));
+            }
+        }
+        for(const auto& loot : lost_objects_.Values()){
+            state = HashCombine(state, static_cast<std::uint64_t>(loot.id));
+            state = HashCombine(state, static_cast<std::uint64_t>(loot.type_loot));
+            state = HashCombine(state, std::bit_cast<std::uint64_t>(loot.pos.x));
+            state = HashCombine(state, std::bit_cast<std::uint64_t>(loot.pos.y));
+        }
+        checksum_ = HashCombine(checksum_, state);
+        return checksum_;
+    }
+
+    std::uint64_t GameSession::GetChecksum() const {
+        return checksum_;
+    }
+
+    void GameSession::InvalidateSnapshot() {
+        snapshot_stale_ = true;
+    }
+
+    void GameSession::PublishSnapshot() {
+        if(!snapshot_stale_){
+            return;
+        }
+        // The buffer released by the previous publish is reused unless a reader still holds it
+        if(!back_snapshot_ || back_snapshot_.use_count() > 1){
+            back_snapshot_ = std::make_shared<Snapshot>();
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        auto& dogs = back_snapshot_->dogs;
+        dogs.resize(dogs_.size());
+        auto state = dogs.begin();
+        for(const auto& [id, dog] : dogs_){
+            state->id = id;
+            state->name = dog->GetDogName();
+            state->pos = dog->GetPosition();
+            state->speed = dog->GetSpeed();
+            state->direction = dog->GetDirection();
+            state->bag.reserve(dog->GetBagCapacity());
+            state->bag = dog->GetBagContent();
+            state->score = dog->GetScore();
+            state->speed_value = dog->GetSpeedValue();
+            state->bag_capacity = dog->GetBagCapacity();
+            ++state;
+        }
+        back_snapshot_->lost_objects = lost_objects_.Values();
+
+        auto previous = std::exchange(front_snapshot_, std::move(back_snapshot_));
+        back_snapshot_ = std::const_pointer_cast<Snapshot>(std::move(previous));
+        snapshot_stale_ = false;
+    }
+
+    std::shared_ptr<const GameSession::Snapshot> GameSession::GetSnapshot() {
+        PublishSnapshot();
+        return front_snapshot_;
+    }
+
+    void GameSession::PushLoot(const LootData& loot) {
+        const LootHandle handle = lost_objects_.Insert(loot);
+        loot_index_.Insert(handle.ToId(), {{loot.pos.x, loot.pos.y}, ObjectsWidth::LOST_OBJ_WIDTH});
+    }
+
     int GameSession::GenerateRandomValue(int max_value) {
-        std::random_device random_device;
-        std::default_random_engine generator(random_device());
         std::uniform_int_distribution<int> dist_roads(0, max_value); 
-        return dist_roads(generator);
+        return dist_roads(random_engine_);
     }
 
     void GameSession::GenerateNewLoot(std::chrono::milliseconds interval, int item_count) {
-        unsigned new_lost_objects = loot_gen_.Generate(interval, lost_objects_.size(), dogs_.size());
+        unsigned new_lost_objects = loot_gen_.Generate(interval, lost_objects_.Size(), dogs_.size());
         for(unsigned i = 0; i < new_lost_objects; i++) {
             Position loot_pos = GenerateRandomPosition();
             int loot_type = GenerateRandomValue(item_count - 1);
-            lost_objects_.emplace_back(LootData{loot_count_++, loot_type, loot_pos}); 
+            PushLoot(LootData{loot_count_++, loot_type, loot_pos}); 
+        }
+        if(new_lost_objects > 0){
+            snapshot_stale_ = true;
         }
     }
 
     Position GameSession::GenerateRandomPosition() {      
-        auto roads = map_->GetRoads();
-        int num_road = GenerateRandomValue(roads.size() - 1);
-
-        std::random_device random_device;
-        std::default_random_engine generator(random_device());
-        model::Point start = roads[num_road].GetStart();
-        model::Point end = roads[num_road].GetEnd();       
-        std::uniform_real_distribution<double> dist_x(std::min(start.x, end.x), std::max(start.x, end.x)); 
-        std::uniform_real_distribution<double> dist_y(std::min(start.y, end.y), std::max(start.y, end.y)); 
-        double x = dist_x(generator);
-        double y = dist_y(generator);
-        return {x, y};
+        std::uniform_real_distribution<double> share(0., 1.);
+        return map_->PointAlongRoads(share(random_engine_));
     }
 
     std::shared_ptr<Dog> GameSession::AddDog(const std::string& user_name) {
-        auto roads = map_->GetRoads();        
         Position point_begin;
         if(random_points_){
             point_begin = GenerateRandomPosition();
         }
         else{
-            point_begin.x = static_cast<double>(roads.at(0).GetStart().x);
-            point_begin.y = static_cast<double>(roads.at(0).GetStart().y);
+            const Point& start = map_->GetRoads().at(0).GetStart();
+            point_begin.x = static_cast<double>(start.x);
+            point_begin.y = static_cast<double>(start.y);
         }
         auto dog = dogs_.emplace(id_count, std::make_shared<Dog>(Dog{id_count, user_name, point_begin}));
         dog.first->second->SetBagCapacity(map_->GetBagCapacity());
         dog.first->second->SetSpeed(map_->GetSpeed());
 
-        dog.first->second->SetListener(retirement_time_);
+        dog.first->second->AttachKinematics(kinematics_);
+        dog.first->second->AttachRetirement(retirement_wheel_, retirement_time_);
+        snapshot_stale_ = true;
 
         ++id_count;
         return dog.first->second;
@@ -338,14 +716,17 @@ namespace model {
 
     void GameSession::AddExistDog(std::shared_ptr<Dog> dog) {
         auto add_dog = dogs_.emplace(dog->GetDogId(), dog);
-        add_dog.first->second->SetListener(retirement_time_); 
+        add_dog.first->second->AttachKinematics(kinematics_);
+        add_dog.first->second->AttachRetirement(retirement_wheel_, retirement_time_);
+        snapshot_stale_ = true;
         if(id_count <= dog->GetDogId()){
             id_count = dog->GetDogId() + 1;
         }
     }
 
     void GameSession::AddLootData(LootData loot) {
-        lost_objects_.push_back(loot);
+        PushLoot(loot);
+        snapshot_stale_ = true;
         if(loot_count_<= loot.id){
             loot_count_ = loot.id + 1;
         }
@@ -357,7 +738,10 @@ namespace model {
         if(listener_){
             listener_->RetirementDog(dog, map_->GetId(), time);
         }   
+        dog->DetachKinematics();
+        dog->DetachRetirement();
         dogs_.erase(dog_id);  
+        snapshot_stale_ = true;
         return retired_dog;   
     }
 
@@ -381,10 +765,34 @@ namespace model {
         return dogs_;
     }
 
-    GameSession::LostObjects& GameSession::GetLostObjects() {
+    const GameSession::LostObjects& GameSession::GetLostObjects() const {
+        return lost_objects_.Values();
+    }
+
+    const GameSession::LootSlots& GameSession::GetLootSlots() const {
         return lost_objects_;
     }
 
+    const collision_detector::SpatialHash& GameSession::GetLootIndex() const {
+        return loot_index_;
+    }
+
+    KinematicsBuffer& GameSession::GetKinematics() {
+        return kinematics_;
+    }
+
+    tick_arena::TickArena& GameSession::GetTickArena() {
+        return tick_arena_;
+    }
+
+    GameSession::TickBacklog& GameSession::GetTickBacklog() {
+        return tick_backlog_;
+    }
+
+    bool GameSession::HasMovingDogs() const {
+        return kinematics_.MovingCount() > 0;
+    }
+
     void GameSession::ExchangeItemForScore(int dog_id) {
         auto dog = dogs_.at(dog_id);
         auto& values = map_->GetValueLoots();
@@ -396,14 +804,15 @@ namespace model {
         int score = std::accumulate(items.begin(), items.end(), 0, item_to_score);
         dog->AddScore(score);
         dog->ReturnBagContents();
+        snapshot_stale_ = true;
     }
 
-    void GameSession::RemoveCollectedItems(const std::set<int>& items_for_delete) {
-        auto rbegin = items_for_delete.rbegin();
-        auto rend = items_for_delete.rend();
-        for(auto it = rbegin; it != rend; it++){
-            lost_objects_.erase(lost_objects_.begin() + *it);
+    void GameSession::RemoveCollectedItems(const std::pmr::vector<LootHandle>& items_for_delete) {
+        for(const auto handle : items_for_delete){
+            lost_objects_.Erase(handle);
+            loot_index_.Erase(handle.ToId());
         }
+        snapshot_stale_ = true;
     }
 
     void Game::AddMap(const Map& map, double speed, int capacity) {
@@ -428,10 +837,13 @@ namespace model {
         }
         else { 
             if(auto* map = FindMap(map_id)) {
-                auto session = sessions_.emplace(map_id, std::make_shared<GameSession>(GameSession{map, gen_data_}));
+                auto session = sessions_.emplace(map_id, std::make_shared<GameSession>(map, gen_data_));
                 if(random_points_){
                     session.first->second->SetRandom();
                 }
+                if(seed_){
+                    session.first->second->SetSeed(HashCombine(*seed_, StableHash(*map_id)));
+                }
                 session.first->second->SetDogRetirementTime(retirement_time_);
                 return session.first->second;
             }
@@ -458,6 +870,27 @@ namespace model {
         random_points_ = true;
     }
 
+    void Game::SetSeed(std::uint64_t seed) {
+        seed_ = seed;
+    }
+
+    const std::optional<std::uint64_t>& Game::GetSeed() const {
+        return seed_;
+    }
+
+    std::uint64_t Game::UpdateChecksum() {
+        for(const auto& map : maps_){
+            if(auto it = sessions_.find(map.GetId()); it != sessions_.end()){
+                checksum_ = HashCombine(checksum_, it->second->UpdateChecksum());
+            }
+        }
+        return checksum_;
+    }
+
+    std::uint64_t Game::GetChecksum() const {
+        return checksum_;
+    }
+
     void Game::SetLootGenData(double period, double probability) {
         gen_data_.period = period;
         gen_data_.probability = probability;
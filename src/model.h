@@ -7,8 +7,17 @@
 #include <set>
 #include <optional>
 #include <map>
+#include <memory_resource>
+#include <chrono>
 #include "tagged.h"
+#include "collision_detector.h"
+#include "spatial_hash.h"
+#include "slot_map.h"
 #include "loot_generator.h"
+#include "road_index.h"
+#include "tick_arena.h"
+#include "timing_wheel.h"
+#include "xoshiro.h"
 
 #include <iostream>
 
@@ -53,6 +62,8 @@ namespace model {
         constexpr static double S_TO_MS = 1000.0;
     };
 
+    constexpr std::chrono::milliseconds DEFAULT_RETIREMENT_TIME{60000};
+
     struct Size {
         Dimension width, height;
     };
@@ -141,9 +152,19 @@ namespace model {
         const Buildings& GetBuildings() const noexcept;
         const Roads& GetRoads() const noexcept;
         const Offices& GetOffices() const noexcept;
+        // Collision items of the offices in the order of GetOffices(); offices never move,
+        // so the items are built once when an office is added.
+        const std::vector<collision_detector::Item>& GetOfficeItems() const noexcept;
         const int GetTypeItemCount() const noexcept;
         const int GetBagCapacity() const noexcept;
         const ValueLoots& GetValueLoots() const noexcept;
+        std::vector<FieldRoad> FindContainRoads(const Position& pos) const;
+        std::optional<road_index::Corridor> FindCorridor(const Position& pos, road_index::Axis axis) const;
+        road_index::MoveResult MoveAlongRoads(const Position& from, const Position& to, 
+                                                std::optional<road_index::Corridor>& corridor) const;
+        // Point at the given share [0, 1) of the total road length; uniform shares give
+        // points spread evenly over the roads regardless of how long each road is.
+        Position PointAlongRoads(double share) const;
 
         void AddRoad(const Road& road);
         void AddBuilding(const Building& building);
@@ -158,29 +179,69 @@ namespace model {
         Id id_;
         std::string name_;
         Roads roads_;
+        std::vector<double> road_length_cdf_;
+        road_index::RoadIndex road_index_{ObjectsWidth::ROAD_WIDTH};
         Buildings buildings_;
         OfficeIdToIndex warehouse_id_to_index_;
         Offices offices_;
+        std::vector<collision_detector::Item> office_items_;
         ValueLoots value_loots_;
         double speed_on_map_ = 1.0;
         int bag_capacity_on_map_ = 3;
         int type_loot_count_ = 0;
     };
 
-    class DogListener {
+    class KinematicsBuffer;
+
+    class DogKinematics {
     public:
-        virtual std::optional<std::chrono::milliseconds> TimerChange(std::chrono::milliseconds delta, bool inaction) = 0;
+        explicit DogKinematics(const Position& pos, const Speed& speed);
+        DogKinematics(const DogKinematics& other);
+        DogKinematics& operator=(const DogKinematics& other);
+        ~DogKinematics();
+
+        Position GetPosition() const;
+        Speed GetSpeed() const;
+        bool IsStopped() const;
+        size_t GetSlot() const;
+
+        void SetPosition(const Position& pos);
+        void SetSpeed(const Speed& speed);
+
+        void Attach(KinematicsBuffer& buffer);
+        void Detach();
+
+    private:
+        friend class KinematicsBuffer;
+
+        Position pos_;
+        Speed speed_;
+        KinematicsBuffer* buffer_ = nullptr;
+        size_t slot_ = 0;
     };
 
-    class TimeChanger : public DogListener {
+    class KinematicsBuffer {
     public:
-        explicit TimeChanger(std::chrono::milliseconds time);        
-        std::optional<std::chrono::milliseconds> TimerChange(std::chrono::milliseconds delta, bool inaction);
+        KinematicsBuffer() = default;
+        KinematicsBuffer(const KinematicsBuffer&) = delete;
+        KinematicsBuffer& operator=(const KinematicsBuffer&) = delete;
+
+        size_t Size() const;
+        size_t MovingCount() const;
+        const std::vector<Position>& Integrate(std::chrono::milliseconds delta);
 
     private:
-        std::chrono::milliseconds all_time_;
-        std::chrono::milliseconds inaction_time_;
-        std::chrono::milliseconds accept_inaction_time_ ;
+        friend class DogKinematics;
+
+        size_t Add(DogKinematics* owner, const Position& pos, const Speed& speed);
+        void Remove(size_t slot);
+
+        std::vector<Position> positions_;
+        std::vector<Speed> speeds_;
+        std::vector<uint8_t> stopped_;
+        std::vector<DogKinematics*> owners_;
+        std::vector<Position> targets_;
+        size_t moving_count_ = 0;
     };
 
     class Dog {
@@ -194,22 +255,31 @@ namespace model {
         using BagContent = std::vector<FindItem>;
 
         explicit Dog(int id, const std::string& nickname, const Position& pos);
+        // Copies are not attached to the retirement wheel of the original
+        Dog(const Dog& other);
+        Dog& operator=(const Dog& other);
         const std::string& GetDogName() const; 
         int GetDogId() const;
-        const Speed& GetSpeed() const;
+        Speed GetSpeed() const;
         double GetSpeedValue() const;
         const int GetBagCapacity() const;
-        const Position& GetPosition() const;
+        Position GetPosition() const;
         const std::string& GetDirection() const;
         const BagContent& GetBagContent() const;
         const int GetScore() const;
+        const std::optional<road_index::Corridor>& GetCorridor() const;
+        size_t GetKinematicsSlot() const;
+        bool IsStopped() const;
+        std::chrono::milliseconds GetPlayTime() const;
 
         void SetSpeed(double speed);
         void SetBagCapacity(int capacity);
         void AddScore(int score);
-        void SetListener(std::chrono::milliseconds time);
-
-        std::optional<std::chrono::milliseconds> InActiveDog(std::chrono::milliseconds delta);
+        void SetCorridor(const road_index::Corridor& corridor);
+        void AttachKinematics(KinematicsBuffer& buffer);
+        void DetachKinematics();
+        void AttachRetirement(timing_wheel::TimingWheel& wheel, std::chrono::milliseconds retirement_time);
+        void DetachRetirement();
 
         void ChangeDirection(const std::string& dir);
         void ChangePosition(const Position& pos);
@@ -218,20 +288,25 @@ namespace model {
         void ReturnBagContents();
 
     private:
-        bool DogIsStop();
+        void RestartInactivity();
 
         int id_; 
         std::string nickname_; 
         double speed_value_;
         int bag_capacity_ = 3;
         BagContent bag_content_;
-        Speed speed_;
-        Position pos_;
+        DogKinematics kinematics_;
         int score_ = 0;
         std::string direction_ = Direction::NORTH;
-        std::shared_ptr<DogListener> listener_ = nullptr;
+        std::optional<road_index::Corridor> corridor_;
+        timing_wheel::Timer retirement_timer_;
+        timing_wheel::TimingWheel* retirement_wheel_ = nullptr;
+        timing_wheel::TimingWheel::Time join_time_ = 0;
+        std::chrono::milliseconds retirement_time_{0};
     };
 
+    road_index::MoveResult MoveDog(const Map& map, Dog& dog, const Position& target);
+
     class SessionListener {
     public:
         virtual void RetirementDog(std::shared_ptr<Dog> dog, const model::Map::Id& map_id, std::chrono::milliseconds time) = 0;
@@ -246,10 +321,43 @@ namespace model {
             Position pos;
         };
 
+        struct TickBacklog {
+            std::chrono::milliseconds loot{0};
+            std::chrono::milliseconds movement{0};
+        };
+
         using Dogs = std::map<int, std::shared_ptr<Dog>>;
         using LostObjects = std::vector<LootData>;
+        using LootSlots = slot_map::SlotMap<LootData>;
+        using LootHandle = slot_map::Handle;
+
+        // Lost objects are indexed in cells of this size; a dog covers a few of them per tick
+        constexpr static double LOOT_CELL_SIZE = 2.;
+        constexpr static size_t LOOT_CELL_CAPACITY = 4;
+
+        struct DogState {
+            int id;
+            std::string name;
+            Position pos;
+            Speed speed;
+            std::string direction;
+            Dog::BagContent bag;
+            int score;
+            double speed_value;
+            int bag_capacity;
+        };
+
+        // Immutable copy of the session state for readers off the simulation strand
+        struct Snapshot {
+            std::vector<DogState> dogs;
+            LostObjects lost_objects;
+        };
 
         explicit GameSession(const Map* map, LootGenData data);
+        GameSession(const GameSession&) = delete;
+        GameSession& operator=(const GameSession&) = delete;
+        ~GameSession();
+
         std::shared_ptr<Dog> AddDog(const std::string& user_name);
         std::shared_ptr<Dog> FindDog(int dog_id);
         
@@ -262,28 +370,55 @@ namespace model {
 
         const Map::Id& GetMapId() const;
         Dogs& GetInfoDogs();
-        LostObjects& GetLostObjects();
+        // Lost objects in no particular order
+        const LostObjects& GetLostObjects() const;
+        const LootSlots& GetLootSlots() const;
+        // Item ids of its events are LootHandle ids
+        const collision_detector::SpatialHash& GetLootIndex() const;
+        KinematicsBuffer& GetKinematics();
+        tick_arena::TickArena& GetTickArena();
+        TickBacklog& GetTickBacklog();
+        bool HasMovingDogs() const;
 
         void SetRandom();
+        void SetSeed(std::uint64_t seed);
         void SetDogRetirementTime(std::chrono::milliseconds time);
+        std::uint64_t UpdateChecksum();
+        std::uint64_t GetChecksum() const;
+        void AdvanceClock(std::chrono::milliseconds delta, std::pmr::vector<int>& inactive_dogs);
+
+        void InvalidateSnapshot();
+        void PublishSnapshot();
+        std::shared_ptr<const Snapshot> GetSnapshot();
 
         void GenerateNewLoot(std::chrono::milliseconds interval, int item_count);
         void ExchangeItemForScore(int dog_id);
-        void RemoveCollectedItems(const std::set<int>& items_for_delete);
+        void RemoveCollectedItems(const std::pmr::vector<LootHandle>& items_for_delete);
 
     private:
+        void PushLoot(const LootData& loot);
         int GenerateRandomValue(int max_value);
         Position GenerateRandomPosition();
 
         bool random_points_ = false;
+        xoshiro::Xoshiro256StarStar random_engine_{xoshiro::SeedFromOs()};
+        std::uint64_t checksum_ = 0;
 
+        KinematicsBuffer kinematics_;
+        timing_wheel::TimingWheel retirement_wheel_;
         Dogs dogs_;
-        LostObjects lost_objects_; 
+        LootSlots lost_objects_; 
+        collision_detector::SpatialHash loot_index_{LOOT_CELL_SIZE};
         const Map* map_; 
         int id_count = 0;
         int loot_count_ = 0;
-        std::chrono::milliseconds retirement_time_;
+        std::chrono::milliseconds retirement_time_{DEFAULT_RETIREMENT_TIME};
         loot_gen::LootGenerator loot_gen_;
+        tick_arena::TickArena tick_arena_;
+        TickBacklog tick_backlog_;
+        std::shared_ptr<const Snapshot> front_snapshot_;
+        std::shared_ptr<Snapshot> back_snapshot_;
+        bool snapshot_stale_ = true;
 
         std::shared_ptr<SessionListener> listener_ = nullptr;
     };
@@ -304,6 +439,10 @@ namespace model {
         const Maps& GetMaps() const noexcept;
         const Map* FindMap(const Map::Id& id) const noexcept;
         void SetRandomaizer();
+        void SetSeed(std::uint64_t seed);
+        const std::optional<std::uint64_t>& GetSeed() const;
+        std::uint64_t UpdateChecksum();
+        std::uint64_t GetChecksum() const;
         void SetLootGenData(double period, double probability);
         void SetDogRetirementTime(double time_s);
         const LootGenData& GetLootGenData() const;
@@ -313,7 +452,9 @@ namespace model {
         GameSessions sessions_;
         MapIdToIndex map_id_to_index_;
         bool random_points_ = false;
-        std::chrono::milliseconds retirement_time_;
+        std::optional<std::uint64_t> seed_;
+        std::uint64_t checksum_ = 0;
+        std::chrono::milliseconds retirement_time_{DEFAULT_RETIREMENT_TIME};
         LootGenData gen_data_;
     };
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/string.hpp>
+#include <boost/serialization/split_member.hpp>
 
 #include "model.h"
 #include "geom.h"
@@ -64,6 +65,17 @@ namespace serialization {
             , bag_content_(dog.GetBagContent()) 
         {}
 
+        explicit DogRepr(const model::GameSession::DogState& dog)
+            : id_(dog.id)
+            , name_(dog.name)
+            , pos_(dog.pos)
+            , bag_capacity_(dog.bag_capacity)
+            , speed_value_(dog.speed_value) 
+            , direction_(dog.direction)
+            , score_(dog.score)
+            , bag_content_(dog.bag) 
+        {}
+
         [[nodiscard]] model::Dog Restore() const {
             model::Dog dog{id_, name_, pos_};
             dog.SetSpeed(speed_value_);     
@@ -106,14 +118,11 @@ namespace serialization {
         using DogsRepr = std::vector<DogRepr>;
         SessionRepr() = default;
 
+        // Keeps only the published snapshot, so the archive can be written off the simulation strand
         explicit SessionRepr(model::GameSession& session)
             : map_id_(*session.GetMapId())
-            , lost_objs_(session.GetLostObjects())
-        {
-            for(auto& dog : session.GetInfoDogs()){
-                dogs_.emplace_back(DogRepr{*dog.second});
-            }
-        }
+            , snapshot_(session.GetSnapshot())
+        {}
 
         std::string GetMapId() {
             return map_id_;
@@ -127,15 +136,41 @@ namespace serialization {
             return lost_objs_;
         }
 
+        // A repr restored by load() has no snapshot and saves the state it has loaded
         template <typename Archive>
-        void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
-            ar & map_id_;
-            ar & dogs_;
-            ar & lost_objs_;
+        void save(Archive& ar, [[maybe_unused]] const unsigned version) const {
+            ar << map_id_;
+            if(!snapshot_){
+                ar << dogs_;
+                ar << lost_objs_;
+                return;
+            }
+            const DogsRepr dogs = MakeDogsRepr();
+            ar << dogs;
+            ar << snapshot_->lost_objects;
         }
 
+        template <typename Archive>
+        void load(Archive& ar, [[maybe_unused]] const unsigned version) {
+            ar >> map_id_;
+            ar >> dogs_;
+            ar >> lost_objs_;
+        }
+
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+
     private:
+        DogsRepr MakeDogsRepr() const {
+            DogsRepr dogs;
+            dogs.reserve(snapshot_->dogs.size());
+            for(const auto& dog : snapshot_->dogs){
+                dogs.emplace_back(dog);
+            }
+            return dogs;
+        }
+
         std::string map_id_;
+        std::shared_ptr<const model::GameSession::Snapshot> snapshot_;
         DogsRepr dogs_;
         model::GameSession::LostObjects lost_objs_;
     };
@@ -63,11 +63,7 @@ namespace postgres {
         w.commit();
     }
 
-    void DataBase::SaveRetiredDog(const model::ToRetiredDogInfo& dog) {  
-        retired_dogs_.Save(model::RetiredDog{model::RetiredDogId::New(), dog.name, dog.score, dog.play_time});
-    }
-
-    const std::vector<model::RetiredDog> DataBase::GetRetiredDogs(int offset, int max_elem) const {
-        return retired_dogs_.LoadDataFromDB(offset, max_elem);
+    model::RetiredDogRepository& DataBase::GetRetiredDogs() {
+        return retired_dogs_;
     }
 } //namespace postgres
\ No newline at end of file
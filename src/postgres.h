@@ -102,8 +102,7 @@ namespace postgres {
     class DataBase {
     public:
         explicit DataBase(const AppConfig& config);
-        void SaveRetiredDog(const model::ToRetiredDogInfo& dog);
-        const std::vector<model::RetiredDog> GetRetiredDogs(int offset, int max_elem) const ;
+        model::RetiredDogRepository& GetRetiredDogs();
 
     private:
         ConnectionPool conn_pull_;
@@ -99,9 +99,10 @@ namespace http_handler {
         return content_type;
     }
 
-    ApiHandler::ApiHandler(app::Application& app, bool accept, extra_data::LootJsonData& loot_data)
+    ApiHandler::ApiHandler(app::Application& app, bool accept, extra_data::LootJsonData& loot_data, bool serve_tick_profile)
         : application_(app)
         , accept_tick_(accept)
+        , serve_tick_profile_(serve_tick_profile)
         , loot_data_(loot_data)
     {}
 
@@ -226,47 +227,76 @@ namespace http_handler {
     }
 
     StringResponse ApiHandler::GetGameState(const StringRequest& request) const {
-        if(request.method() != http::verb::get && request.method() != http::verb::head)
-                    return http_response_handler::MakeNotAllowResponse(request.version(), request.keep_alive(), 
-                                                        "Only GET or HEAD methods is expected", http::verb::get);  
+        return PrepareGameState(request)();
+    } 
 
-        return ExecuteAuthorized(request, [this, &request](const app::Token& token) {
-            try{
-                const auto game_state = this->application_.GameState(token);
-                json::object players;
-                for(const auto& dog : game_state.dogs) {
-                    json::array bag;
-                    for(const auto& item : dog.second->GetBagContent()){
-                        bag.push_back({{JsonRequestsNames::ITEM_ID, item.id},
-                                       {JsonRequestsNames::ITEM_TYPE, item.type_item}});
-                    }
-                    json::value dog_info = {{JsonRequestsNames::DOG_POS, {dog.second->GetPosition().x, dog.second->GetPosition().y}}, 
-                                            {JsonRequestsNames::DOG_SPD, {dog.second->GetSpeed().w, dog.second->GetSpeed().h}},
-                                            {JsonRequestsNames::DOG_DIR, dog.second->GetDirection()},
-                                            {JsonRequestsNames::DOG_BAG, bag},
-                                            {JsonRequestsNames::DOG_SCORE, dog.second->GetScore()}};
-                    players.emplace(std::to_string(dog.second->GetDogId()), dog_info);
-                }
-                json::object lost_objects;
-                for(auto& lost_obj : game_state.lost_objects) {
-                    json::value obj_info = {{JsonRequestsNames::LOST_OBJ_TYPE, lost_obj.type_loot}, 
-                                            {JsonRequestsNames::LOST_OBJ_POS, {lost_obj.pos.x, lost_obj.pos.y}}};
-                    lost_objects.emplace(std::to_string(lost_obj.id), obj_info);
-                }
+    bool ApiHandler::IsGameStateRequest(const StringRequest& req) const {
+        std::string_view uri_str = req.target();
+        if(!uri_str.starts_with(URIEndpoints::ENDPOINT_API)){
+            return false;
+        }
+        uri_str.remove_prefix(URIEndpoints::ENDPOINT_API.size());
+        if(!uri_str.starts_with(URIEndpoints::ENDPOINT_GAME)){
+            return false;
+        }
+        uri_str.remove_prefix(URIEndpoints::ENDPOINT_GAME.size());
+        return uri_str.starts_with(URIEndpoints::ENDPOINT_STATE);
+    }
 
-                json::object result;
-                result.emplace(JsonRequestsNames::PLAYERS, players);
-                result.emplace(JsonRequestsNames::LOST_OBJ, lost_objects);
+    ApiHandler::ResponseJob ApiHandler::PrepareGameState(const StringRequest& request) const {
+        auto ready = [](StringResponse response) {
+            return ResponseJob{[response = std::move(response)] { return response; }};
+        };
+        if(request.method() != http::verb::get && request.method() != http::verb::head){
+            return ready(http_response_handler::MakeNotAllowResponse(request.version(), request.keep_alive(), 
+                                                        "Only GET or HEAD methods is expected", http::verb::get));
+        }
+        auto token = TryExtractToken(request);
+        if(!token){
+            return ready(http_response_handler::MakeUnauthorizedResponse(request.version(), request.keep_alive(), 
+                                        ErrorResponseType::INVALID_TOKEN, "Authorization header is missing"));
+        }
+        try{
+            auto snapshot = application_.GameState(*token).snapshot;
+            return [snapshot = std::move(snapshot), version = request.version(), keep_alive = request.keep_alive()] {
+                return MakeGameStateResponse(*snapshot, version, keep_alive);
+            };
+        }
+        catch(const app::ApiError& error){               
+            return ready(http_response_handler::MakeUnauthorizedResponse(request.version(), request.keep_alive(), 
+                                        ErrorResponseType::UNKNOWN_TOKEN, "Player token has not been found"));
+        }
+    }
 
-                std::string response_body = json::serialize(result);
-                return http_response_handler::MakeJsonResponse(request.version(), request.keep_alive(), response_body);
+    StringResponse ApiHandler::MakeGameStateResponse(const model::GameSession::Snapshot& snapshot, unsigned version, bool keep_alive) {
+        json::object players;
+        for(const auto& dog : snapshot.dogs) {
+            json::array bag;
+            for(const auto& item : dog.bag){
+                bag.push_back({{JsonRequestsNames::ITEM_ID, item.id},
+                               {JsonRequestsNames::ITEM_TYPE, item.type_item}});
             }
-            catch(const app::ApiError& error){               
-                return http_response_handler::MakeUnauthorizedResponse(request.version(), request.keep_alive(), 
-                                            ErrorResponseType::UNKNOWN_TOKEN, "Player token has not been found");
-            }
-        });
-    } 
+            json::value dog_info = {{JsonRequestsNames::DOG_POS, {dog.pos.x, dog.pos.y}}, 
+                                    {JsonRequestsNames::DOG_SPD, {dog.speed.w, dog.speed.h}},
+                                    {JsonRequestsNames::DOG_DIR, dog.direction},
+                                    {JsonRequestsNames::DOG_BAG, bag},
+                                    {JsonRequestsNames::DOG_SCORE, dog.score}};
+            players.emplace(std::to_string(dog.id), dog_info);
+        }
+        json::object lost_objects;
+        for(auto& lost_obj : snapshot.lost_objects) {
+            json::value obj_info = {{JsonRequestsNames::LOST_OBJ_TYPE, lost_obj.type_loot}, 
+                                    {JsonRequestsNames::LOST_OBJ_POS, {lost_obj.pos.x, lost_obj.pos.y}}};
+            lost_objects.emplace(std::to_string(lost_obj.id), obj_info);
+        }
+
+        json::object result;
+        result.emplace(JsonRequestsNames::PLAYERS, players);
+        result.emplace(JsonRequestsNames::LOST_OBJ, lost_objects);
+
+        std::string response_body = json::serialize(result);
+        return http_response_handler::MakeJsonResponse(version, keep_alive, response_body);
+    }
 
     StringResponse ApiHandler::GetPlayerAction(const StringRequest& request) {
         if(request.method() != http::verb::post)
@@ -344,6 +374,14 @@ namespace http_handler {
         return http_response_handler::MakeJsonResponse(request.version(), request.keep_alive(), response_body); 
     }
 
+    StringResponse ApiHandler::GetTickProfile(const StringRequest& request) const {
+        if(request.method() != http::verb::get && request.method() != http::verb::head)
+                return http_response_handler::MakeNotAllowResponse(request.version(), request.keep_alive(), 
+                                                        "Only GET or HEAD methods is expected", http::verb::get);  
+        std::string response_body = json::serialize(json_loader::TickProfileToJson(application_.TickProfile(), application_.GetDegradationLevel()));
+        return http_response_handler::MakeJsonResponse(request.version(), request.keep_alive(), response_body); 
+    }
+
     StringResponse ApiHandler::HandlerApiRequest(const StringRequest& req) {
         std::string_view uri_str = req.target();
         http::status status = http::status::ok;
@@ -376,16 +414,21 @@ namespace http_handler {
             }
             std::string map_name = std::string(uri_str.substr(1));
             return GetMap(req, map_name);
+        } else if(uri_str.starts_with(URIEndpoints::ENDPOINT_ADMIN)) {
+            uri_str.remove_prefix(URIEndpoints::ENDPOINT_ADMIN.size());
+            if(serve_tick_profile_ && uri_str == URIEndpoints::ENDPOINT_TICK_PROFILE){
+                return GetTickProfile(req);
+            }
         }
         return http_response_handler::MakeInvalidArgumentResponse(req.version(), req.keep_alive(), 
                                             ErrorResponseType::BAD_REQUEST, "Invalid endpoint");
     }
 
     RequestHandler::RequestHandler(const std::filesystem::path& root, Strand& api_strand, 
-                            app::Application& app, bool accept_tick, extra_data::LootJsonData& loot_data)
+                            app::Application& app, bool accept_tick, extra_data::LootJsonData& loot_data, bool serve_tick_profile)
         : root_{std::move(root)}
         , api_strand_(api_strand)
-        , api_handler_(app, accept_tick, loot_data)
+        , api_handler_(app, accept_tick, loot_data, serve_tick_profile)
     {}
 
     RequestHandler::FileRequestResult RequestHandler::HandleFileRequest(const StringRequest& req) const {
@@ -15,6 +15,7 @@
 
 #include <variant>
 #include <chrono>
+#include <functional>
 #include <optional>
 
 namespace http_handler {
@@ -42,10 +43,17 @@ namespace http_handler {
             http::verb allow_method = http::verb::get;
         };
 
-        explicit ApiHandler(app::Application& app, bool accept, extra_data::LootJsonData& loot_data);
+        using ResponseJob = std::function<StringResponse()>;
+
+        explicit ApiHandler(app::Application& app, bool accept, extra_data::LootJsonData& loot_data, bool serve_tick_profile);
         bool IsApiRequest(const StringRequest& req);
+        bool IsGameStateRequest(const StringRequest& req) const;
         StringResponse HandlerApiRequest(const StringRequest& req);
+        // Runs on the api strand; the returned job only reads the state snapshot and can run on any thread
+        ResponseJob PrepareGameState(const StringRequest& request) const;
     private:
+        static StringResponse MakeGameStateResponse(const model::GameSession::Snapshot& snapshot, unsigned version, bool keep_alive);
+
         std::optional<app::Token> TryExtractToken(const StringRequest& request) const;
 
         template <typename Fn>
@@ -67,8 +75,10 @@ namespace http_handler {
         StringResponse GetPlayerAction(const StringRequest& request);
         StringResponse GetTick(const StringRequest& request);
         StringResponse GetRecords(const StringRequest& request) const;
+        StringResponse GetTickProfile(const StringRequest& request) const;
 
         bool accept_tick_ = true;
+        bool serve_tick_profile_ = false;
         app::Application& application_;
         extra_data::LootJsonData& loot_data_;
     };
@@ -78,7 +88,7 @@ namespace http_handler {
         using Strand = net::strand<net::io_context::executor_type>;
 
         explicit RequestHandler(const std::filesystem::path& root, Strand& api_strand, app::Application& app, 
-                                    bool accept_tick, extra_data::LootJsonData& loot_data);
+                                    bool accept_tick, extra_data::LootJsonData& loot_data, bool serve_tick_profile);
 
         RequestHandler(const RequestHandler&) = delete;
         RequestHandler& operator=(const RequestHandler&) = delete;
@@ -88,6 +98,25 @@ namespace http_handler {
             auto version = req.version();
             auto keep_alive = req.keep_alive();       
             try {
+                if (api_handler_.IsGameStateRequest(req)) {
+                    auto handle = [self = shared_from_this(), send,
+                                req = std::forward<decltype(req)>(req), version, keep_alive] {
+                        try {
+                            assert(self->api_strand_.running_in_this_thread());
+                            auto job = self->api_handler_.PrepareGameState(req);
+                            net::post(self->api_strand_.get_inner_executor(), [self, send, job = std::move(job), version, keep_alive] {
+                                try {
+                                    send(job());
+                                } catch (...) {
+                                    send(self->ReportServerError(version, keep_alive));
+                                }
+                            });
+                        } catch (...) { 
+                            send(self->ReportServerError(version, keep_alive));
+                        }
+                    };
+                    return net::dispatch(api_strand_, handle);
+                }
                 if (api_handler_.IsApiRequest(req)) {
                     auto handle = [self = shared_from_this(), send,
                                 req = std::forward<decltype(req)>(req), version, keep_alive] {
@@ -0,0 +1,142 @@
+#include "road_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace road_index {
+
+    bool Corridor::Contains(geom::Point2D pos) const {
+        constexpr double eps = RoadIndex::EPS;
+        return min.x - eps <= pos.x && pos.x <= max.x + eps && min.y - eps <= pos.y && pos.y <= max.y + eps;
+    }
+
+    geom::Point2D Corridor::Clamp(geom::Point2D pos) const {
+        auto clamp = [](double value, double lo, double hi){
+            constexpr double eps = RoadIndex::EPS;
+            return value < lo - eps ? lo : (value > hi + eps ? hi : value);
+        };
+        return {clamp(pos.x, min.x, max.x), clamp(pos.y, min.y, max.y)};
+    }
+
+    RoadIndex::RoadIndex(double half_width)
+        : half_width_(half_width)
+    {}
+
+    void RoadIndex::AddHorizontal(int y, int x0, int x1, size_t road_id) {
+        AddToLane(rows_, y, std::min(x0, x1) - half_width_, std::max(x0, x1) + half_width_, road_id);
+    }
+
+    void RoadIndex::AddVertical(int x, int y0, int y1, size_t road_id) {
+        AddToLane(columns_, x, std::min(y0, y1) - half_width_, std::max(y0, y1) + half_width_, road_id);
+    }
+
+    void RoadIndex::AddToLane(Lanes& lanes, int lane, double lo, double hi, size_t road_id) {
+        auto& [intervals, max_hi, corridors] = lanes[lane];
+        auto pos = std::upper_bound(intervals.begin(), intervals.end(), lo, [](double value, const Interval& interval){
+            return value < interval.lo;
+        });
+        const size_t index = pos - intervals.begin();
+        intervals.insert(pos, Interval{lo, hi, road_id});
+
+        // prefix maxima after the new interval grow to hi until one already exceeds it
+        max_hi.insert(max_hi.begin() + index, index == 0 ? hi : std::max(max_hi[index - 1], hi));
+        for(size_t i = index + 1; i < max_hi.size() && max_hi[i] < hi; i++){
+            max_hi[i] = hi;
+        }
+
+        // the new interval joins every corridor it touches into one
+        auto first = std::lower_bound(corridors.begin(), corridors.end(), lo - EPS, [](const Span& span, double value){
+            return span.hi < value;
+        });
+        auto last = std::upper_bound(first, corridors.end(), hi + EPS, [](double value, const Span& span){
+            return value < span.lo;
+        });
+        if(first == last){
+            corridors.insert(first, Span{lo, hi});
+            return;
+        }
+        first->lo = std::min(first->lo, lo);
+        first->hi = std::max(std::prev(last)->hi, hi);
+        corridors.erase(std::next(first), last);
+    }
+
+    void RoadIndex::FindInLanes(const Lanes& lanes, double across, double along, std::vector<size_t>& result) const {
+        const int first_lane = static_cast<int>(std::ceil(across - half_width_ - EPS));
+        const int last_lane = static_cast<int>(std::floor(across + half_width_ + EPS));
+        for(int lane = first_lane; lane <= last_lane; lane++){
+            auto it = lanes.find(lane);
+            if(it == lanes.end()){
+                continue;
+            }
+            const auto& [intervals, max_hi, corridors] = it->second;
+            auto end = std::upper_bound(intervals.begin(), intervals.end(), along + EPS, [](double value, const Interval& interval){
+                return value < interval.lo;
+            });
+            for(size_t i = end - intervals.begin(); i > 0 && max_hi[i - 1] >= along - EPS; i--){
+                if(intervals[i - 1].hi >= along - EPS){
+                    result.push_back(intervals[i - 1].road_id);
+                }
+            }
+        }
+    }
+
+    std::vector<size_t> RoadIndex::FindRoads(geom::Point2D pos) const {
+        std::vector<size_t> result;
+        FindInLanes(rows_, pos.y, pos.x, result);
+        FindInLanes(columns_, pos.x, pos.y, result);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::optional<Corridor> RoadIndex::FindCorridorInLanes(const Lanes& lanes, Axis axis, double across, double along) const {
+        const int first_lane = static_cast<int>(std::ceil(across - half_width_ - EPS));
+        const int last_lane = static_cast<int>(std::floor(across + half_width_ + EPS));
+        for(int lane = first_lane; lane <= last_lane; lane++){
+            auto it = lanes.find(lane);
+            if(it == lanes.end()){
+                continue;
+            }
+            const auto& corridors = it->second.corridors;
+            auto next = std::upper_bound(corridors.begin(), corridors.end(), along + EPS, [](double value, const Span& span){
+                return value < span.lo;
+            });
+            if(next == corridors.begin() || std::prev(next)->hi < along - EPS){
+                continue;
+            }
+            const Span& span = *std::prev(next);
+            if(axis == Axis::HORIZONTAL){
+                return Corridor{axis, {span.lo, lane - half_width_}, {span.hi, lane + half_width_}};
+            }
+            return Corridor{axis, {lane - half_width_, span.lo}, {lane + half_width_, span.hi}};
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Corridor> RoadIndex::FindCorridor(geom::Point2D pos, Axis axis) const {
+        if(axis == Axis::HORIZONTAL){
+            if(auto corridor = FindCorridorInLanes(rows_, Axis::HORIZONTAL, pos.y, pos.x)){
+                return corridor;
+            }
+            return FindCorridorInLanes(columns_, Axis::VERTICAL, pos.x, pos.y);
+        }
+        if(auto corridor = FindCorridorInLanes(columns_, Axis::VERTICAL, pos.x, pos.y)){
+            return corridor;
+        }
+        return FindCorridorInLanes(rows_, Axis::HORIZONTAL, pos.y, pos.x);
+    }
+
+    MoveResult RoadIndex::Sweep(geom::Point2D from, geom::Point2D to, std::optional<Corridor>& corridor) const {
+        if(from == to){
+            return {from, 0., false};
+        }
+        if(!corridor || !corridor->Contains(from)){
+            corridor = FindCorridor(from, to.x != from.x ? Axis::HORIZONTAL : Axis::VERTICAL);
+            if(!corridor){
+                return {from, 0., true};
+            }
+        }
+        const geom::Point2D end = corridor->Clamp(to);
+        return {end, std::abs(end.x - from.x) + std::abs(end.y - from.y), end != to};
+    }
+
+}  // namespace road_index
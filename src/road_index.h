@@ -0,0 +1,69 @@
+#pragma once
+
+#include "geom.h"
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace road_index {
+
+    enum class Axis { HORIZONTAL, VERTICAL };
+
+    struct Corridor {
+        bool Contains(geom::Point2D pos) const;
+        geom::Point2D Clamp(geom::Point2D pos) const;
+
+        Axis axis;
+        geom::Point2D min;
+        geom::Point2D max;
+    };
+
+    struct MoveResult {
+        geom::Point2D end;
+        double distance;
+        bool blocked;
+    };
+
+    class RoadIndex {
+    public:
+        constexpr static double EPS = 1e-10;
+
+        explicit RoadIndex(double half_width);
+
+        void AddHorizontal(int y, int x0, int x1, size_t road_id);
+        void AddVertical(int x, int y0, int y1, size_t road_id);
+
+        std::vector<size_t> FindRoads(geom::Point2D pos) const;
+        std::optional<Corridor> FindCorridor(geom::Point2D pos, Axis axis) const;
+        MoveResult Sweep(geom::Point2D from, geom::Point2D to, std::optional<Corridor>& corridor) const;
+
+    private:
+        struct Interval {
+            double lo, hi;
+            size_t road_id;
+        };
+
+        struct Span {
+            double lo, hi;
+        };
+
+        struct Lane {
+            std::vector<Interval> intervals;
+            std::vector<double> max_hi;
+            std::vector<Span> corridors;
+        };
+
+        using Lanes = std::unordered_map<int, Lane>;
+
+        void AddToLane(Lanes& lanes, int lane, double lo, double hi, size_t road_id);
+        void FindInLanes(const Lanes& lanes, double across, double along, std::vector<size_t>& result) const;
+        std::optional<Corridor> FindCorridorInLanes(const Lanes& lanes, Axis axis, double across, double along) const;
+
+        double half_width_;
+        Lanes rows_;
+        Lanes columns_;
+    };
+
+}  // namespace road_index
@@ -0,0 +1,58 @@
+#pragma once
+#include <chrono>
+#include <stdexcept>
+
+namespace ticker {
+
+    using namespace std::literals;
+
+    class SimulationClock {
+    public:
+        struct Advance {
+            int steps;
+            std::chrono::milliseconds dropped;
+        };
+
+        explicit SimulationClock(std::chrono::milliseconds step, int max_substeps)
+            : step_{step}
+            , max_substeps_{max_substeps} {
+            if (step_ <= 0ms || max_substeps_ <= 0) {
+                throw std::invalid_argument("Simulation step and substep limit must be positive");
+            }
+        }
+
+        // Accumulates elapsed wall time and returns how many fixed steps to simulate.
+        // Time beyond max_substeps steps is dropped rather than carried to the next wake-up.
+        Advance Add(std::chrono::milliseconds elapsed) {
+            accumulator_ += elapsed;
+            auto steps = accumulator_ / step_;
+            std::chrono::milliseconds dropped{0};
+            if (steps > max_substeps_) {
+                dropped = (steps - max_substeps_) * step_;
+                steps = max_substeps_;
+            }
+            accumulator_ -= dropped + steps * step_;
+            total_dropped_ += dropped;
+            return {static_cast<int>(steps), dropped};
+        }
+
+        std::chrono::milliseconds GetStep() const {
+            return step_;
+        }
+
+        std::chrono::milliseconds GetPending() const {
+            return accumulator_;
+        }
+
+        std::chrono::milliseconds GetTotalDropped() const {
+            return total_dropped_;
+        }
+
+    private:
+        std::chrono::milliseconds step_;
+        int max_substeps_;
+        std::chrono::milliseconds accumulator_{0};
+        std::chrono::milliseconds total_dropped_{0};
+    };
+
+}  // namespace ticker
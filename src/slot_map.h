@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace slot_map {
+
+    // Generation-checked reference to a slot map element. A handle of an erased element
+    // never matches the element that later reuses its slot.
+    struct Handle {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        uint64_t ToId() const {
+            return (static_cast<uint64_t>(generation) << 32) | index;
+        }
+
+        static Handle FromId(uint64_t id) {
+            return {static_cast<uint32_t>(id), static_cast<uint32_t>(id >> 32)};
+        }
+
+        bool operator==(const Handle&) const = default;
+    };
+
+    // Values are kept dense for iteration; erase moves the last value into the hole, so
+    // the order of values is unspecified and only handles identify elements.
+    template <typename T>
+    class SlotMap {
+    public:
+        Handle Insert(const T& value) {
+            uint32_t index;
+            if (!free_.empty()) {
+                index = free_.back();
+                free_.pop_back();
+            } else {
+                index = static_cast<uint32_t>(slots_.size());
+                slots_.push_back({});
+                // so that Erase never allocates
+                free_.reserve(slots_.capacity());
+            }
+            slots_[index].dense = static_cast<uint32_t>(values_.size());
+            values_.push_back(value);
+            dense_to_slot_.push_back(index);
+            return {index, slots_[index].generation};
+        }
+
+        void Erase(Handle handle) {
+            CheckHandle(handle);
+            Slot& slot = slots_[handle.index];
+            const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+            if (slot.dense != last) {
+                values_[slot.dense] = std::move(values_[last]);
+                dense_to_slot_[slot.dense] = dense_to_slot_[last];
+                slots_[dense_to_slot_[slot.dense]].dense = slot.dense;
+            }
+            values_.pop_back();
+            dense_to_slot_.pop_back();
+            slot.dense = FREE;
+            ++slot.generation;
+            free_.push_back(handle.index);
+        }
+
+        bool Contains(Handle handle) const {
+            return handle.index < slots_.size() && slots_[handle.index].dense != FREE 
+                && slots_[handle.index].generation == handle.generation;
+        }
+
+        const T& At(Handle handle) const {
+            CheckHandle(handle);
+            return values_[slots_[handle.index].dense];
+        }
+
+        Handle HandleAt(size_t dense) const {
+            const uint32_t index = dense_to_slot_.at(dense);
+            return {index, slots_[index].generation};
+        }
+
+        void Clear() {
+            for (uint32_t index : dense_to_slot_) {
+                slots_[index].dense = FREE;
+                ++slots_[index].generation;
+                free_.push_back(index);
+            }
+            values_.clear();
+            dense_to_slot_.clear();
+        }
+
+        const std::vector<T>& Values() const {
+            return values_;
+        }
+
+        size_t Size() const {
+            return values_.size();
+        }
+
+        // Upper bound of Handle::index, for per-slot bitsets
+        size_t SlotCount() const {
+            return slots_.size();
+        }
+
+    private:
+        constexpr static uint32_t FREE = UINT32_MAX;
+
+        struct Slot {
+            uint32_t dense = FREE;
+            uint32_t generation = 0;
+        };
+
+        void CheckHandle(Handle handle) const {
+            if (!Contains(handle)) {
+                throw std::out_of_range("Stale slot map handle");
+            }
+        }
+
+        std::vector<T> values_;
+        std::vector<uint32_t> dense_to_slot_;
+        std::vector<Slot> slots_;
+        std::vector<uint32_t> free_;
+    };
+
+}  // namespace slot_map
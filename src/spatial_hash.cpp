@@ -0,0 +1,95 @@
+#include "spatial_hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace collision_detector {
+
+    uint64_t CellKey(int64_t x, int64_t y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x) ^ 0x80000000u) << 32) 
+             | (static_cast<uint32_t>(y) ^ 0x80000000u);
+    }
+
+    SpatialHash::SpatialHash(double cell_size)
+        : cell_size_(cell_size) {
+        assert(cell_size_ > 0);
+    }
+
+    size_t SpatialHash::Size() const {
+        return size_;
+    }
+
+    void SpatialHash::Insert(size_t id, const Item& item) {
+        const size_t slot = Slot(id);
+        if(slot >= locations_.size()){
+            locations_.resize(slot + 1);
+        }
+        Location& location = locations_[slot];
+        if(location.used){
+            throw std::invalid_argument("Duplicate item id");
+        }
+        location = {id, CellKey(Cell(item.position.x), Cell(item.position.y)), true};
+        buckets_[location.key].Add(id, item);
+        max_item_width_ = std::max(max_item_width_, item.width);
+        ++size_;
+    }
+
+    void SpatialHash::Erase(size_t id) {
+        const size_t slot = Slot(id);
+        if(slot >= locations_.size() || !locations_[slot].used || locations_[slot].id != id){
+            return;
+        }
+        Location& location = locations_[slot];
+        auto& bucket = buckets_.find(location.key)->second;
+        bucket.SwapRemove(std::find(bucket.id.begin(), bucket.id.end(), id) - bucket.id.begin());
+        location.used = false;
+        --size_;
+    }
+
+    void SpatialHash::Clear() {
+        locations_.clear();
+        buckets_.clear();
+        max_item_width_ = 0;
+        size_ = 0;
+    }
+
+    void SpatialHash::ReserveArea(geom::Point2D min, geom::Point2D max, size_t items_per_cell) {
+        for(int64_t x = Cell(min.x); x <= Cell(max.x); x++){
+            for(int64_t y = Cell(min.y); y <= Cell(max.y); y++){
+                buckets_[CellKey(x, y)].Reserve(items_per_cell);
+            }
+        }
+    }
+
+    void SpatialHash::Find(const Gatherer& gatherer, std::pmr::vector<GatheringEvent>& result) const {
+        const double reach = gatherer.width + max_item_width_;
+        const int64_t x0 = Cell(std::min(gatherer.start_pos.x, gatherer.end_pos.x) - reach);
+        const int64_t x1 = Cell(std::max(gatherer.start_pos.x, gatherer.end_pos.x) + reach);
+        const int64_t y0 = Cell(std::min(gatherer.start_pos.y, gatherer.end_pos.y) - reach);
+        const int64_t y1 = Cell(std::max(gatherer.start_pos.y, gatherer.end_pos.y) + reach);
+        if(static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1) > static_cast<double>(buckets_.size())){
+            for(const auto& [key, bucket] : buckets_){
+                GatherRange(gatherer, bucket, 0, bucket.Size(), result);
+            }
+            return;
+        }
+        for(int64_t x = x0; x <= x1; x++){
+            for(int64_t y = y0; y <= y1; y++){
+                if(auto bucket = buckets_.find(CellKey(x, y)); bucket != buckets_.end()){
+                    GatherRange(gatherer, bucket->second, 0, bucket->second.Size(), result);
+                }
+            }
+        }
+    }
+
+    int64_t SpatialHash::Cell(double coord) const {
+        return static_cast<int64_t>(std::floor(coord / cell_size_));
+    }
+
+    size_t SpatialHash::Slot(size_t id) {
+        return static_cast<uint32_t>(id);
+    }
+
+}  // namespace collision_detector
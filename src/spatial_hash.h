@@ -0,0 +1,52 @@
+#pragma once
+
+#include "collision_detector.h"
+#include "collision_kernel.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace collision_detector {
+
+    // Key of the cell (x, y), biased so that the order of keys follows (x, y) for negative cells too
+    uint64_t CellKey(int64_t x, int64_t y);
+
+    // Persistent spatial hash of items under stable ids. The owner inserts and erases items
+    // as they appear and disappear instead of rebuilding a broad phase every tick.
+    // Event item ids are the ids given to Insert. The low 32 bits of an id index a dense
+    // table, as the slot of a slot map handle does, so ids should be reused like slots.
+    // Cells are kept when they empty, so once they have grown, items coming and going do not allocate.
+    class SpatialHash {
+    public:
+        explicit SpatialHash(double cell_size);
+
+        size_t Size() const;
+
+        void Insert(size_t id, const Item& item);
+        void Erase(size_t id);
+        void Clear();
+        // Creates the cells of the rectangle in advance with room for items_per_cell items each
+        void ReserveArea(geom::Point2D min, geom::Point2D max, size_t items_per_cell);
+
+        // Appends the events of a moving gatherer in no particular order
+        void Find(const Gatherer& gatherer, std::pmr::vector<GatheringEvent>& result) const;
+
+    private:
+        struct Location {
+            size_t id = 0;
+            uint64_t key = 0;
+            bool used = false;
+        };
+
+        int64_t Cell(double coord) const;
+        static size_t Slot(size_t id);
+
+        double cell_size_;
+        double max_item_width_ = 0;
+        size_t size_ = 0;
+        std::vector<Location> locations_;
+        std::unordered_map<uint64_t, ItemColumns> buckets_;
+    };
+
+}  // namespace collision_detector
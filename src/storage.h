@@ -35,6 +35,8 @@ using namespace std::literals;
         constexpr static std::string_view ENDPOINT_ACTION = "/player/action"sv;
         constexpr static std::string_view ENDPOINT_TICKS = "/tick"sv;
         constexpr static std::string_view ENDPOINT_RECORDS = "/records"sv;
+        constexpr static std::string_view ENDPOINT_ADMIN = "/v1/admin"sv;
+        constexpr static std::string_view ENDPOINT_TICK_PROFILE = "/tick-profile"sv;
     };
 
     struct ErrorResponseType {
@@ -0,0 +1,48 @@
+#include "tick_arena.h"
+
+namespace tick_arena {
+
+    size_t TickArena::SpillCounter::TakeSpilled() {
+        size_t spilled = spilled_;
+        spilled_ = 0;
+        return spilled;
+    }
+
+    void* TickArena::SpillCounter::do_allocate(size_t bytes, size_t alignment) {
+        spilled_ += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void TickArena::SpillCounter::do_deallocate(void* p, size_t bytes, size_t alignment) {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool TickArena::SpillCounter::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    TickArena::TickArena(size_t initial_size)
+        : capacity_(initial_size)
+        , buffer_(std::make_unique<std::byte[]>(capacity_)) {
+        resource_.emplace(buffer_.get(), capacity_, &spill_);
+    }
+
+    std::pmr::memory_resource* TickArena::Reset() {
+        resource_.reset();
+        if (const size_t spilled = spill_.TakeSpilled(); spilled > 0) {
+            capacity_ += spilled;
+            buffer_ = std::make_unique<std::byte[]>(capacity_);
+        }
+        resource_.emplace(buffer_.get(), capacity_, &spill_);
+        return &*resource_;
+    }
+
+    std::pmr::memory_resource* TickArena::GetResource() {
+        return &*resource_;
+    }
+
+    size_t TickArena::GetCapacity() const {
+        return capacity_;
+    }
+
+}  // namespace tick_arena
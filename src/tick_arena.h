@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace tick_arena {
+
+    // Monotonic arena for the temporaries of one session tick. Reset() rewinds it;
+    // if the previous tick did not fit, the buffer first grows to the high-water mark,
+    // so in steady state a tick does not touch the global heap.
+    class TickArena {
+    public:
+        constexpr static size_t INITIAL_SIZE = 16 * 1024;
+
+        explicit TickArena(size_t initial_size = INITIAL_SIZE);
+        TickArena(const TickArena&) = delete;
+        TickArena& operator=(const TickArena&) = delete;
+
+        std::pmr::memory_resource* Reset();
+        std::pmr::memory_resource* GetResource();
+        size_t GetCapacity() const;
+
+    private:
+        class SpillCounter : public std::pmr::memory_resource {
+        public:
+            size_t TakeSpilled();
+
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+            size_t spilled_ = 0;
+        };
+
+        size_t capacity_;
+        std::unique_ptr<std::byte[]> buffer_;
+        SpillCounter spill_;
+        std::optional<std::pmr::monotonic_buffer_resource> resource_;
+    };
+
+}  // namespace tick_arena
@@ -0,0 +1,49 @@
+#include "tick_budget.h"
+
+namespace tick_budget {
+
+    void TickBudget::SetBudget(std::chrono::nanoseconds budget) {
+        budget_ = budget;
+        over_budget_ticks_ = 0;
+        under_budget_ticks_ = 0;
+        level_ = Level::NORMAL;
+    }
+
+    Level TickBudget::Record(std::chrono::nanoseconds tick_time) {
+        if (budget_ <= 0ns) {
+            return level_;
+        }
+        Level level = level_;
+        if (tick_time > budget_) {
+            under_budget_ticks_ = 0;
+            if (++over_budget_ticks_ >= ESCALATE_AFTER && level != Level::DEFERRED_RETIREMENT) {
+                level = static_cast<Level>(static_cast<int>(level) + 1);
+                over_budget_ticks_ = 0;
+            }
+        }
+        else if (tick_time.count() < budget_.count() * RECOVER_RATIO) {
+            over_budget_ticks_ = 0;
+            if (++under_budget_ticks_ >= RECOVER_AFTER && level != Level::NORMAL) {
+                level = static_cast<Level>(static_cast<int>(level) - 1);
+                under_budget_ticks_ = 0;
+            }
+        }
+        else {
+            over_budget_ticks_ = 0;
+            under_budget_ticks_ = 0;
+        }
+        level_ = level;
+        return level;
+    }
+
+    void TickBudget::SetLevel(Level level) {
+        over_budget_ticks_ = 0;
+        under_budget_ticks_ = 0;
+        level_ = level;
+    }
+
+    Level TickBudget::GetLevel() const {
+        return level_;
+    }
+
+}  // namespace tick_budget
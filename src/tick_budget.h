@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string_view>
+
+namespace tick_budget {
+
+    using namespace std::literals;
+
+    // Levels are cumulative: every level also keeps the measures of the levels below it.
+    enum class Level {
+        NORMAL,
+        REDUCED_LOOT,
+        SPARSE_COLLISIONS,
+        DEFERRED_RETIREMENT
+    };
+
+    constexpr std::array<std::string_view, 4> LEVEL_NAMES = {
+        "normal"sv, "reducedLoot"sv, "sparseCollisions"sv, "deferredRetirement"sv
+    };
+
+    class TickBudget {
+    public:
+        constexpr static int ESCALATE_AFTER = 3;
+        constexpr static int RECOVER_AFTER = 20;
+        constexpr static double RECOVER_RATIO = 0.75;
+
+        void SetBudget(std::chrono::nanoseconds budget);
+        Level Record(std::chrono::nanoseconds tick_time);
+        // Without a budget the level stays where it was set
+        void SetLevel(Level level);
+        Level GetLevel() const;
+
+    private:
+        std::chrono::nanoseconds budget_{0};
+        std::atomic<Level> level_{Level::NORMAL};
+        int over_budget_ticks_ = 0;
+        int under_budget_ticks_ = 0;
+    };
+
+}  // namespace tick_budget
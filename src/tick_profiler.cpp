@@ -0,0 +1,88 @@
+#include "tick_profiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace tick_profiler {
+
+    void Histogram::Record(uint64_t value) {
+        counts_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t current_max = max_.load(std::memory_order_relaxed);
+        while (value > current_max && !max_.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    Summary Histogram::GetSummary() const {
+        std::array<uint64_t, BUCKETS> counts;
+        Summary summary;
+        for (size_t i = 0; i < BUCKETS; i++) {
+            counts[i] = counts_[i].load(std::memory_order_relaxed);
+            summary.count += counts[i];
+        }
+        summary.max = max_.load(std::memory_order_relaxed);
+        if (summary.count == 0) {
+            return summary;
+        }
+
+        auto percentile = [&](double quantile) {
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * summary.count)));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKETS; i++) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    return std::min(BucketUpperBound(i), summary.max);
+                }
+            }
+            return summary.max;
+        };
+        summary.p50 = percentile(0.5);
+        summary.p90 = percentile(0.9);
+        summary.p99 = percentile(0.99);
+        return summary;
+    }
+
+    size_t Histogram::BucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+        const int exponent = 63 - std::countl_zero(value);
+        const size_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+        return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub_bucket;
+    }
+
+    uint64_t Histogram::BucketUpperBound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        const uint64_t sub_bucket = SUB_BUCKETS + (index - SUB_BUCKETS) % SUB_BUCKETS;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    MapProfile* TickProfiler::GetMap(const std::string& map_id) {
+#ifdef TICK_PROFILING
+        std::lock_guard lock{mutex_};
+        auto& profile = maps_[map_id];
+        if (!profile) {
+            profile = std::make_unique<MapProfile>();
+        }
+        return profile.get();
+#else
+        return nullptr;
+#endif
+    }
+
+    TickProfiler::Report TickProfiler::GetReport() const {
+        std::lock_guard lock{mutex_};
+        Report report;
+        for (const auto& [map_id, profile] : maps_) {
+            auto& map_report = report[map_id];
+            for (size_t i = 0; i < PHASE_COUNT; i++) {
+                map_report[i] = profile->phases[i].GetSummary();
+            }
+        }
+        return report;
+    }
+
+}  // namespace tick_profiler
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace tick_profiler {
+
+    using namespace std::literals;
+
+    enum class Phase {
+        SESSION,
+        LOOT_GENERATION,
+        INACTIVITY,
+        GATHERERS,
+        GATHER_EVENTS,
+        ACTION_EVENTS,
+        REMOVE_ITEMS,
+        SAVE_RETIRED,
+        PUBLISH_SNAPSHOT,
+        COUNT
+    };
+
+    constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::COUNT);
+
+    constexpr std::array<std::string_view, PHASE_COUNT> PHASE_NAMES = {
+        "session"sv, "lootGeneration"sv, "inactivity"sv, "gatherers"sv,
+        "gatherEvents"sv, "actionEvents"sv, "removeItems"sv, "saveRetired"sv, "publishSnapshot"sv
+    };
+
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+    };
+
+    // Log-linear histogram of nanosecond durations: every power of two is split into
+    // 16 linear buckets, so a reported percentile is within 1/16 of the recorded value.
+    class Histogram {
+    public:
+        constexpr static int SUB_BUCKET_BITS = 4;
+        constexpr static uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        constexpr static size_t BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+        void Record(uint64_t value);
+        Summary GetSummary() const;
+
+    private:
+        static size_t BucketIndex(uint64_t value);
+        static uint64_t BucketUpperBound(size_t index);
+
+        std::array<std::atomic<uint64_t>, BUCKETS> counts_{};
+        std::atomic<uint64_t> max_{0};
+    };
+
+    struct MapProfile {
+        std::array<Histogram, PHASE_COUNT> phases;
+    };
+
+    class TickProfiler {
+    public:
+        using MapReport = std::array<Summary, PHASE_COUNT>;
+        using Report = std::map<std::string, MapReport>;
+
+        MapProfile* GetMap(const std::string& map_id);
+        Report GetReport() const;
+
+    private:
+        mutable std::mutex mutex_;
+        std::map<std::string, std::unique_ptr<MapProfile>> maps_;
+    };
+
+#ifdef TICK_PROFILING
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(MapProfile* profile, Phase phase)
+            : histogram_(profile ? &profile->phases[static_cast<size_t>(phase)] : nullptr)
+            , start_(Clock::now()) {
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer() {
+            if (histogram_) {
+                histogram_->Record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count());
+            }
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Histogram* histogram_;
+        Clock::time_point start_;
+    };
+#else
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(MapProfile*, Phase) {
+        }
+    };
+#endif
+
+}  // namespace tick_profiler
@@ -0,0 +1,195 @@
+#include "timing_wheel.h"
+
+#include <bit>
+
+namespace timing_wheel {
+
+    Timer::Timer(int id)
+        : id_(id)
+    {}
+
+    Timer::Timer(const Timer& other)
+        : id_(other.id_)
+    {}
+
+    Timer& Timer::operator=(const Timer& other) {
+        id_ = other.id_;
+        return *this;
+    }
+
+    Timer::~Timer() {
+        if (wheel_) {
+            wheel_->Cancel(*this);
+        }
+    }
+
+    int Timer::GetId() const {
+        return id_;
+    }
+
+    bool Timer::IsScheduled() const {
+        return wheel_ != nullptr;
+    }
+
+    std::uint64_t Timer::GetDeadline() const {
+        return deadline_;
+    }
+
+    TimingWheel::~TimingWheel() {
+        for (auto& level : levels_) {
+            for (auto& slot : level) {
+                DetachAll(slot);
+            }
+        }
+        DetachAll(overflow_);
+    }
+
+    TimingWheel::Time TimingWheel::GetNow() const {
+        return now_;
+    }
+
+    size_t TimingWheel::Size() const {
+        return size_;
+    }
+
+    void TimingWheel::Schedule(Timer& timer, Time deadline) {
+        if (timer.wheel_) {
+            timer.wheel_->Cancel(timer);
+        }
+        timer.deadline_ = deadline;
+        timer.wheel_ = this;
+        ++size_;
+        Link(timer);
+    }
+
+    void TimingWheel::Cancel(Timer& timer) {
+        if (timer.wheel_ != this) {
+            return;
+        }
+        Unlink(timer);
+        timer.wheel_ = nullptr;
+        --size_;
+    }
+
+    void TimingWheel::Advance(Time now, std::pmr::vector<int>& expired) {
+        if (size_ == 0) {
+            now_ = std::max(now_, now);
+            return;
+        }
+        while (now_ < now) {
+            const Time boundary = (now_ | (SLOTS - 1)) + 1;
+            if (now < boundary) {
+                ExpireUntil(now, expired);
+                now_ = now;
+                break;
+            }
+            ExpireUntil(boundary - 1, expired);
+            now_ = boundary;
+            int level = 1;
+            for (; level < LEVELS; level++) {
+                const size_t index = (boundary >> (level * SLOT_BITS)) & (SLOTS - 1);
+                Cascade(levels_[level][index]);
+                if (index != 0) {
+                    break;
+                }
+            }
+            if (level == LEVELS) {
+                Cascade(overflow_);
+            }
+            ExpireSlot(0, expired);
+        }
+    }
+
+    void TimingWheel::Link(Timer& timer) {
+        const Time deadline = std::max(timer.deadline_, now_ + 1);
+        const Time diff = deadline ^ now_;
+        Slot* slot = &overflow_;
+        if (diff < SLOTS) {
+            const size_t index = deadline & (SLOTS - 1);
+            slot = &levels_[0][index];
+            occupied_ |= std::uint64_t{1} << index;
+        }
+        else if (const int level = (std::bit_width(diff) - 1) / SLOT_BITS; level < LEVELS) {
+            slot = &levels_[level][(deadline >> (level * SLOT_BITS)) & (SLOTS - 1)];
+        }
+        timer.slot_ = slot;
+        timer.prev_ = nullptr;
+        timer.next_ = *slot;
+        if (*slot) {
+            (*slot)->prev_ = &timer;
+        }
+        *slot = &timer;
+    }
+
+    void TimingWheel::Unlink(Timer& timer) {
+        if (timer.prev_) {
+            timer.prev_->next_ = timer.next_;
+        }
+        else {
+            *timer.slot_ = timer.next_;
+        }
+        if (timer.next_) {
+            timer.next_->prev_ = timer.prev_;
+        }
+        if (!*timer.slot_ && timer.slot_ >= &levels_[0].front() && timer.slot_ <= &levels_[0].back()) {
+            occupied_ &= ~(std::uint64_t{1} << (timer.slot_ - &levels_[0].front()));
+        }
+        timer.slot_ = nullptr;
+        timer.prev_ = nullptr;
+        timer.next_ = nullptr;
+    }
+
+    void TimingWheel::Cascade(Slot& slot) {
+        Timer* timer = slot;
+        slot = nullptr;
+        while (timer) {
+            Timer* next = timer->next_;
+            Link(*timer);
+            timer = next;
+        }
+    }
+
+    void TimingWheel::ExpireSlot(size_t index, std::pmr::vector<int>& expired) {
+        Timer* timer = levels_[0][index];
+        levels_[0][index] = nullptr;
+        occupied_ &= ~(std::uint64_t{1} << index);
+        while (timer) {
+            Timer* next = timer->next_;
+            timer->wheel_ = nullptr;
+            timer->slot_ = nullptr;
+            timer->prev_ = nullptr;
+            timer->next_ = nullptr;
+            --size_;
+            expired.push_back(timer->id_);
+            timer = next;
+        }
+    }
+
+    void TimingWheel::ExpireUntil(Time end, std::pmr::vector<int>& expired) {
+        // now_ and end lie in the same rotation of the lowest level.
+        const size_t first = (now_ + 1) & (SLOTS - 1);
+        const size_t last = end & (SLOTS - 1);
+        if (end <= now_) {
+            return;
+        }
+        std::uint64_t pending = occupied_ & (~std::uint64_t{0} << first) & (~std::uint64_t{0} >> (SLOTS - 1 - last));
+        while (pending) {
+            const size_t index = std::countr_zero(pending);
+            pending &= pending - 1;
+            ExpireSlot(index, expired);
+        }
+    }
+
+    void TimingWheel::DetachAll(Slot& slot) {
+        for (Timer* timer = slot; timer; ) {
+            Timer* next = timer->next_;
+            timer->wheel_ = nullptr;
+            timer->slot_ = nullptr;
+            timer->prev_ = nullptr;
+            timer->next_ = nullptr;
+            timer = next;
+        }
+        slot = nullptr;
+    }
+
+}  // namespace timing_wheel
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace timing_wheel {
+
+    class TimingWheel;
+
+    // Intrusive wheel entry: scheduling and cancelling never allocate.
+    class Timer {
+    public:
+        explicit Timer(int id = 0);
+        Timer(const Timer& other);
+        Timer& operator=(const Timer& other);
+        ~Timer();
+
+        int GetId() const;
+        bool IsScheduled() const;
+        std::uint64_t GetDeadline() const;
+
+    private:
+        friend class TimingWheel;
+
+        int id_;
+        std::uint64_t deadline_ = 0;
+        TimingWheel* wheel_ = nullptr;
+        Timer** slot_ = nullptr;
+        Timer* prev_ = nullptr;
+        Timer* next_ = nullptr;
+    };
+
+    // Hierarchical timing wheel with 1ms resolution. Level L holds timers whose deadline
+    // first differs from the current time in the L-th group of SLOT_BITS bits; its slots are
+    // cascaded into lower levels when the time crosses their boundary, so Advance costs
+    // O(expired + cascaded) and does not depend on the number of scheduled timers.
+    class TimingWheel {
+    public:
+        using Time = std::uint64_t;
+
+        constexpr static int SLOT_BITS = 6;
+        constexpr static size_t SLOTS = size_t{1} << SLOT_BITS;
+        constexpr static int LEVELS = 4;
+
+        TimingWheel() = default;
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+        ~TimingWheel();
+
+        Time GetNow() const;
+        size_t Size() const;
+
+        // Deadlines that are not in the future expire on the next Advance.
+        void Schedule(Timer& timer, Time deadline);
+        void Cancel(Timer& timer);
+        void Advance(Time now, std::pmr::vector<int>& expired);
+
+    private:
+        using Slot = Timer*;
+
+        void Link(Timer& timer);
+        void Unlink(Timer& timer);
+        void Cascade(Slot& slot);
+        void ExpireSlot(size_t index, std::pmr::vector<int>& expired);
+        void ExpireUntil(Time end, std::pmr::vector<int>& expired);
+        void DetachAll(Slot& slot);
+
+        Time now_ = 0;
+        size_t size_ = 0;
+        std::array<std::array<Slot, SLOTS>, LEVELS> levels_{};
+        std::uint64_t occupied_ = 0;
+        Slot overflow_ = nullptr;
+    };
+
+}  // namespace timing_wheel
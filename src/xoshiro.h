@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace xoshiro {
+
+    // xoshiro256** by Blackman and Vigna: 32 bytes of state, a few cycles per number.
+    // Not suitable for secrets. Satisfies UniformRandomBitGenerator.
+    class Xoshiro256StarStar {
+    public:
+        using result_type = std::uint64_t;
+        using State = std::array<std::uint64_t, 4>;
+
+        explicit Xoshiro256StarStar(std::uint64_t seed = 0) {
+            Seed(seed);
+        }
+
+        explicit Xoshiro256StarStar(const State& state)
+            : state_(state) {
+        }
+
+        // Expands the seed with splitmix64, so that close seeds give unrelated streams
+        void Seed(std::uint64_t seed) {
+            for (auto& word : state_) {
+                seed += 0x9e3779b97f4a7c15ULL;
+                std::uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                word = z ^ (z >> 31);
+            }
+        }
+
+        result_type operator()() {
+            const std::uint64_t result = Rotl(state_[1] * 5, 7) * 9;
+            const std::uint64_t t = state_[1] << 17;
+            state_[2] ^= state_[0];
+            state_[3] ^= state_[1];
+            state_[1] ^= state_[2];
+            state_[0] ^= state_[3];
+            state_[2] ^= t;
+            state_[3] = Rotl(state_[3], 45);
+            return result;
+        }
+
+        static constexpr result_type min() {
+            return 0;
+        }
+
+        static constexpr result_type max() {
+            return std::numeric_limits<result_type>::max();
+        }
+
+    private:
+        static std::uint64_t Rotl(std::uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        State state_;
+    };
+
+    // One read of OS entropy, for seeding at startup rather than per number
+    inline std::uint64_t SeedFromOs() {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32) | device();
+    }
+
+}  // namespace xoshiro
@@ -1,15 +1,22 @@
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
+#include <random>
+#include <span>
 #include <sstream>
+#include <thread>
+#include <tuple>
 #include <iostream>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_contains.hpp>
 #include <catch2/matchers/catch_matchers_predicate.hpp>
 
 #include "../src/collision_detector.h"
+#include "../src/collision_kernel.h"
 
 namespace Catch {
     template<>
@@ -98,25 +105,27 @@ EqualEventsMatcher<Range, Predicate> EqualEvents(Range& range, Predicate predica
 } 
 
 SCENARIO("collision detector tests", "[Collision Detector]") {
+    using collision_detector::BroadPhase;
+    const auto broad_phase = GENERATE(BroadPhase::NONE, BroadPhase::UNIFORM_GRID);
 
     WHEN("1 gatherer and 0 items") {
         ItemGathererTest test{{}, {{0, {1.5, 5.5},{8.4, 5.5}, 1}}};
         THEN("no events") {
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             CHECK(events.empty());
         }
     }
     WHEN("0 gatherer and 2 item") {
         ItemGathererTest test{{{{3.8, 6.1}, 0}, {{7.1, 5.2}, 0}}, {}};
         THEN("no events") {
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             CHECK(events.empty());
         }
     }
     WHEN("1 gatherer and 2 items in range") {
         ItemGathererTest test{{{{3.57, 6.1}, 0}, {{5.64, 5.2}, 0}}, {{0, {1.5, 5.5},{8.4, 5.5}, 1}}};
         THEN("all items collected") {
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             std::vector<collision_detector::GatheringEvent> gat_events = {{0, 0, 0.6 * 0.6, 0.3}, {1, 0, 0.3 * 0.3, 0.6}};
             CHECK(events.size() == 2);
             CHECK_THAT(events, EqualEvents(gat_events, equal_event));
@@ -125,7 +134,7 @@ SCENARIO("collision detector tests", "[Collision Detector]") {
     WHEN("1 gatherer and 2 items out range") {
         ItemGathererTest test{{{{3.8, 6.6}, 0}, {{7.1, 4.2}, 0}}, {{0, {1.5, 5.5},{8.4, 5.5}, 1}}};
         THEN("no collected items") {
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             CHECK(events.empty());
         }
     }
@@ -133,7 +142,7 @@ SCENARIO("collision detector tests", "[Collision Detector]") {
         ItemGathererTest test{{{{7.02, 4.55}, 0}}, {{0, {1.5, 5.5},{8.4, 5.5}, 1}, {1, {6.5, 3.5},{6.5, 7.}, 1}}};
 
         THEN("item collected by faster gatherer") {
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             std::vector<collision_detector::GatheringEvent> gat_events = {{0, 1, 0.52 * 0.52, 0.3}, {0, 0, 0.95 * 0.95, 0.8}};
             CHECK(events.size() == 2);
             CHECK(events.front().gatherer_id == 1);
@@ -143,7 +152,7 @@ SCENARIO("collision detector tests", "[Collision Detector]") {
     WHEN("1 gatherer and 4 items (3 - in range, 1 - out range)"){
         ItemGathererTest test{{{{5., 5.5}, 0}, {{9., 4.5}, 0}, {{2., 5.2}, 0}, {{7., 3.9}, 0}}, {{0, {0, 5.},{10., 5.}, 1}}};
         THEN("events in right order and correct values") {            
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             std::vector<collision_detector::GatheringEvent> gat_events = {{2, 0, 0.2 * 0.2, 0.2}, {0, 0, 0.5 * 0.5, 0.5}, {1, 0, 0.5 * 0.5, 0.9}};
             CHECK(events.size() == 3);
             CHECK_THAT(events, EqualEvents(gat_events, equal_event));
@@ -152,17 +161,163 @@ SCENARIO("collision detector tests", "[Collision Detector]") {
     WHEN("non-horizonal and non-vertical direction gatherer"){
         ItemGathererTest test{{{{2., 2.5}, 0}}, {{0, {1., 1.},{3., 3.}, 0.5}}}; 
         THEN("right item must collected") {            
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             CHECK(events.size() == 1);
         }
     }
     WHEN("item width non 0") {
         ItemGathererTest test{{{{3.57, 6.6}, 0.5}}, {{0, {1.5, 5.5},{8.4, 5.5}, 1}}};
         THEN("event counted") {
-            auto events = FindGatherEvents(test);
+            auto events = FindGatherEvents(test, std::pmr::get_default_resource(), broad_phase);
             std::vector<collision_detector::GatheringEvent> gat_events = {{0, 0, 1.1 * 1.1, 0.3}};
             CHECK(events.size() == 1);
             CHECK_THAT(events, EqualEvents(gat_events, equal_event));
         }
     }
+}
+
+SCENARIO("uniform grid broad phase", "[Collision Detector]") {
+    using collision_detector::BroadPhase;
+
+    GIVEN("many random items and gatherers") {
+        std::mt19937 generator{7};
+        std::uniform_real_distribution<double> coord{-50., 50.};
+        std::uniform_real_distribution<double> step{-5., 5.};
+        std::uniform_int_distribution<int> width{0, 3};
+        std::vector<collision_detector::Item> items;
+        for(int i = 0; i < 500; i++){
+            items.push_back({{coord(generator), coord(generator)}, width(generator) * 0.1});
+        }
+        // items on cell borders and duplicates make ties in time
+        for(int i = 0; i < 50; i++){
+            items.push_back({{static_cast<double>(i % 10), 0.}, 0.});
+            items.push_back({{static_cast<double>(i % 10), 0.}, 0.});
+        }
+        std::vector<collision_detector::Gatherer> gatherers;
+        for(size_t i = 0; i < 300; i++){
+            geom::Point2D start{coord(generator), coord(generator)};
+            geom::Point2D end = start;
+            switch(i % 4){
+                case 0: end.x += step(generator); break;
+                case 1: end.y += step(generator); break;
+                case 2: end.x += step(generator); end.y += step(generator); break;
+                default: break;
+            }
+            gatherers.push_back({i, start, end, 0.6});
+        }
+        gatherers.push_back({300, {-1., 0.}, {11., 0.}, 0.6});
+        gatherers.push_back({301, {11., 0.}, {-1., 0.}, 0.6});
+        gatherers.push_back({302, {-100., -100.}, {100., 100.}, 0.6});
+        ItemGathererTest test{items, gatherers};
+
+        WHEN("events are found with and without the grid") {
+            auto brute_force = FindGatherEvents(test, std::pmr::get_default_resource(), BroadPhase::NONE);
+            auto grid = FindGatherEvents(test, std::pmr::get_default_resource(), BroadPhase::UNIFORM_GRID);
+
+            THEN("the events and their order are identical") {
+                REQUIRE(brute_force.size() > 100);
+                CHECK(std::is_sorted(brute_force.begin(), brute_force.end(), [](const auto& lhs, const auto& rhs){
+                    return std::tie(lhs.time, lhs.gatherer_id, lhs.item_id) < std::tie(rhs.time, rhs.gatherer_id, rhs.item_id);
+                }));
+                REQUIRE(grid.size() == brute_force.size());
+                for(size_t i = 0; i < grid.size(); i++){
+                    CHECK(grid[i].item_id == brute_force[i].item_id);
+                    CHECK(grid[i].gatherer_id == brute_force[i].gatherer_id);
+                    CHECK(grid[i].sq_distance == brute_force[i].sq_distance);
+                    CHECK(grid[i].time == brute_force[i].time);
+                }
+            }
+        }
+        WHEN("the gatherers are split between threads") {
+            collision_detector::ParallelFor parallel_for = [](size_t count, const std::function<void(size_t)>& job){
+                std::vector<std::thread> threads;
+                for(size_t i = 0; i < count; i++){
+                    threads.emplace_back(job, i);
+                }
+                for(auto& thread : threads){
+                    thread.join();
+                }
+            };
+            std::pmr::monotonic_buffer_resource arena;
+            collision_detector::Parallelism parallelism{&parallel_for, 3};
+            const auto broad_phase = GENERATE(BroadPhase::NONE, BroadPhase::UNIFORM_GRID);
+            std::vector<collision_detector::Gatherer> many = gatherers;
+            while(many.size() < collision_detector::PARALLEL_MIN_GATHERERS){
+                many.insert(many.end(), gatherers.begin(), gatherers.end());
+            }
+            for(size_t i = 0; i < many.size(); i++){
+                many[i].id = i;
+            }
+            auto sequential = FindGatherEvents(items, many, &arena, broad_phase);
+            auto parallel = FindGatherEvents(items, many, &arena, broad_phase, parallelism);
+
+            THEN("the merged events are in the sequential order") {
+                REQUIRE(parallel.size() == sequential.size());
+                for(size_t i = 0; i < parallel.size(); i++){
+                    CHECK(parallel[i].item_id == sequential[i].item_id);
+                    CHECK(parallel[i].gatherer_id == sequential[i].gatherer_id);
+                    CHECK(parallel[i].time == sequential[i].time);
+                }
+            }
+        }
+        WHEN("the same input is passed as spans") {
+            auto from_provider = FindGatherEvents(test);
+            auto from_spans = FindGatherEvents(std::span<const collision_detector::Item>{items}, 
+                                               std::span<const collision_detector::Gatherer>{gatherers});
+
+            THEN("the provider adapter gives the same events") {
+                REQUIRE(from_spans.size() == from_provider.size());
+                for(size_t i = 0; i < from_spans.size(); i++){
+                    CHECK(from_spans[i].item_id == from_provider[i].item_id);
+                    CHECK(from_spans[i].gatherer_id == from_provider[i].gatherer_id);
+                    CHECK(from_spans[i].time == from_provider[i].time);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("batched collection kernel", "[Collision Detector]") {
+    GIVEN("a block of random items and a moving gatherer") {
+        std::mt19937 generator{11};
+        std::uniform_real_distribution<double> coord{-10., 10.};
+        std::uniform_int_distribution<int> width{0, 5};
+        std::vector<double> x, y, w;
+        for(size_t i = 0; i < collision_detector::BATCH_SIZE - 3; i++){
+            x.push_back(coord(generator));
+            y.push_back(coord(generator));
+            w.push_back(width(generator) * 0.1);
+        }
+        // items exactly on the path ends and close to the path
+        x.insert(x.end(), {-3., 4., 0.5});
+        y.insert(y.end(), {-2., 3., 0.6});
+        w.insert(w.end(), {0., 0.5, 0.});
+        collision_detector::Gatherer gatherer{7, {-3., -2.}, {4., 3.}, 0.6};
+
+        WHEN("it is processed by the " << collision_detector::GetKernelName() << " kernel") {
+            double proj_ratio[collision_detector::BATCH_SIZE];
+            double sq_distance[collision_detector::BATCH_SIZE];
+            const auto mask = collision_detector::CollectBatch(gatherer, {x.data(), y.data(), w.data(), x.size()}, 
+                                                               proj_ratio, sq_distance);
+
+            THEN("every item matches the scalar TryCollectPoint exactly") {
+                for(size_t i = 0; i < x.size(); i++){
+                    auto expected = collision_detector::TryCollectPoint(gatherer.start_pos, gatherer.end_pos, {x[i], y[i]});
+                    CHECK(proj_ratio[i] == expected.proj_ratio);
+                    CHECK(sq_distance[i] == expected.sq_distance);
+                    CHECK(((mask >> i) & 1) == expected.IsCollected(gatherer.width + w[i]));
+                }
+                CHECK(mask != 0);
+            }
+        }
+        WHEN("the block is shorter than a vector") {
+            double proj_ratio[3];
+            double sq_distance[3];
+            const auto mask = collision_detector::CollectBatch(gatherer, {x.data() + x.size() - 3, y.data() + y.size() - 3, 
+                                                                          w.data() + w.size() - 3, 3}, proj_ratio, sq_distance);
+            THEN("the tail is collected too") {
+                CHECK(mask == 0b111);
+            }
+        }
+    }
 }
\ No newline at end of file
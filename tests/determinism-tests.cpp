@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/app.h"
+#include "null_retired_dogs.h"
+
+namespace {
+
+    model::Game MakeGame(std::uint64_t seed) {
+        model::Game game;
+        for (const std::string id : {"small", "big"}) {
+            model::Map map{model::Map::Id{id}, id};
+            for (int i = 0; i <= 40; i += 10) {
+                map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, i}, 40});
+                map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{i, 0}, 40});
+            }
+            map.AddOffice(model::Office{model::Office::Id{"office"}, {20, 20}, {0, 0}});
+            map.SetScoreForLoot(10);
+            map.SetScoreForLoot(20);
+            game.AddMap(map, 3., 2);
+        }
+        game.SetLootGenData(1., 0.5);
+        game.SetDogRetirementTime(3.);
+        game.SetRandomaizer();
+        game.SetSeed(seed);
+        return game;
+    }
+
+    // Runs a fixed workload and returns the checksum after every tick
+    std::vector<std::uint64_t> Replay(std::uint64_t seed, unsigned threads, int dog_count = 20, bool one_map = false,
+                                      int ticks = 200) {
+        using namespace std::literals;
+
+        model::Game game = MakeGame(seed);
+        test_support::NullRetiredDogRepository retired_dogs;
+        app::Application app{game, retired_dogs};
+        app.SetTickThreads(threads);
+
+        std::vector<app::Token> tokens;
+        for (int i = 0; i < dog_count; i++) {
+            tokens.push_back(app.JoinGame(i % 2 && !one_map ? "small" : "big", "dog"s + std::to_string(i)).token_);
+        }
+
+        const std::string directions[] = {model::Direction::NORTH, model::Direction::EAST,
+                                          model::Direction::SOUTH, model::Direction::WEST, ""};
+        std::vector<std::uint64_t> checksums;
+        for (int tick = 0; tick < ticks; tick++) {
+            for (size_t i = 0; i < tokens.size(); i++) {
+                if ((tick * 7 + i * 3) % 11 == 0) {
+                    try {
+                        app.ActionMove(tokens[i], directions[(tick + i) % 5]);
+                    } catch (...) {
+                        // the dog has already retired
+                    }
+                }
+            }
+            app.Tick(50ms);
+            checksums.push_back(app.GetChecksum());
+        }
+        return checksums;
+    }
+
+}  // namespace
+
+SCENARIO("Deterministic simulation") {
+    GIVEN("a recorded workload") {
+        WHEN("it is replayed with the same seed") {
+            auto reference = Replay(42, 1);
+            auto replay = Replay(42, 1);
+            THEN("every tick has the same state") {
+                CHECK(replay == reference);
+            }
+            AND_WHEN("the sessions are ticked in parallel") {
+                auto parallel = Replay(42, 4);
+                THEN("the state matches the sequential engine bit for bit") {
+                    CHECK(parallel == reference);
+                }
+            }
+        }
+        WHEN("one crowded map is replayed") {
+            const int dogs = static_cast<int>(collision_detector::PARALLEL_MIN_GATHERERS) * 2;
+            auto reference = Replay(42, 1, dogs, true, 40);
+            THEN("the collision search split across threads gives the same state") {
+                CHECK(Replay(42, 4, dogs, true, 40) == reference);
+            }
+        }
+        WHEN("it is replayed with another seed") {
+            THEN("the loot is placed differently") {
+                CHECK(Replay(42, 1).back() != Replay(43, 1).back());
+            }
+        }
+    }
+}
@@ -57,4 +57,255 @@ SCENARIO("Lost objects generation"){
             }
         }      
     }   
-}
\ No newline at end of file
+}
+
+SCENARIO("Map office items"){
+    GIVEN("a map with several offices"){
+        model::Map test_map{model::Map::Id{"1"}, "test"};
+        test_map.AddOffice(model::Office{model::Office::Id{"a"}, {1, 2}, {0, 0}});
+        test_map.AddOffice(model::Office{model::Office::Id{"b"}, {5, 0}, {0, 0}});
+        test_map.AddOffice(model::Office{model::Office::Id{"c"}, {0, 7}, {0, 0}});
+
+        THEN("every office has its own collision item in the same order"){
+            const auto& items = test_map.GetOfficeItems();
+            REQUIRE(items.size() == test_map.GetOffices().size());
+            for(size_t i = 0; i < items.size(); i++){
+                const auto& pos = test_map.GetOffices()[i].GetPosition();
+                CHECK(items[i].position.x == pos.x);
+                CHECK(items[i].position.y == pos.y);
+                CHECK(items[i].width == model::ObjectsWidth::OFFICE_WIDTH);
+            }
+        }
+        WHEN("a duplicate office is added"){
+            CHECK_THROWS(test_map.AddOffice(model::Office{model::Office::Id{"b"}, {3, 3}, {0, 0}}));
+            THEN("the items are unchanged"){
+                CHECK(test_map.GetOfficeItems().size() == 3);
+            }
+        }
+    }
+}
+
+SCENARIO("Dog kinematics buffer"){
+    GIVEN("game session with several dogs"){
+        model::LootGenData loot_generator{0.5, 1};
+        model::Map test_map{model::Map::Id{"1"}, "test"};
+        test_map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 20});
+        model::GameSession test_session(&test_map, loot_generator);
+        std::vector<std::shared_ptr<model::Dog>> dogs;
+        for(int i = 0; i < 7; i++){
+            dogs.push_back(test_session.AddDog(std::to_string(i)));
+            dogs.back()->ChangePosition({i * 1.5, 0.1 * i});
+            dogs.back()->ChangeDirection(i % 2 ? model::Direction::EAST : model::Direction::SOUTH);
+        }
+        auto& kinematics = test_session.GetKinematics();
+
+        WHEN("positions are integrated"){
+            const auto& targets = kinematics.Integrate(1234ms);
+            THEN("every target matches the scalar formula"){
+                REQUIRE(targets.size() == dogs.size());
+                for(const auto& dog : dogs){
+                    const auto& pos = dog->GetPosition();
+                    const auto& speed = dog->GetSpeed();
+                    const auto& target = targets[dog->GetKinematicsSlot()];
+                    CHECK(target.x == pos.x + speed.w * 1234 * model::ConvertValues::MS_TO_S);
+                    CHECK(target.y == pos.y + speed.h * 1234 * model::ConvertValues::MS_TO_S);
+                }
+            }
+        }
+        WHEN("a dog leaves the session"){
+            auto dog_id = dogs[2]->GetDogId();
+            auto last_pos = dogs.back()->GetPosition();
+            test_session.DeleteDog(dog_id, 0ms);
+            THEN("remaining dogs keep their state"){
+                CHECK(kinematics.Size() == dogs.size() - 1);
+                CHECK(dogs.back()->GetPosition().x == last_pos.x);
+                CHECK(dogs.back()->GetPosition().y == last_pos.y);
+                CHECK(dogs.back()->GetKinematicsSlot() == 2);
+            }
+            AND_THEN("removed dog keeps its own copy of the state"){
+                CHECK(dogs[2]->GetPosition().x == 3.);
+                CHECK(dogs[2]->GetSpeed().h == 1.);
+            }
+        }
+        WHEN("some dogs stop"){
+            dogs[0]->StopMove();
+            dogs[3]->StopMove();
+            THEN("only moving dogs are counted"){
+                CHECK(kinematics.MovingCount() == dogs.size() - 2);
+                CHECK(dogs[0]->IsStopped());
+                CHECK(!dogs[1]->IsStopped());
+            }
+            AND_THEN("session without moving dogs is idle"){
+                for(auto& dog : dogs){
+                    dog->StopMove();
+                }
+                CHECK(kinematics.MovingCount() == 0);
+                CHECK(!test_session.HasMovingDogs());
+                dogs[5]->ChangeDirection(model::Direction::WEST);
+                CHECK(test_session.HasMovingDogs());
+            }
+            AND_THEN("removing a stopped dog keeps the count"){
+                test_session.DeleteDog(dogs[0]->GetDogId(), 0ms);
+                CHECK(kinematics.MovingCount() == dogs.size() - 2);
+            }
+        }
+        WHEN("a dog is copied"){
+            model::Dog copy = *dogs[1];
+            copy.ChangePosition({100., 100.});
+            THEN("the original is not affected"){
+                CHECK(dogs[1]->GetPosition().x == 1.5);
+                CHECK(kinematics.Size() == dogs.size());
+            }
+        }
+    }
+}
+
+SCENARIO("Dog retirement"){
+    GIVEN("game session with 10s retirement time"){
+        model::LootGenData loot_generator{0.5, 1};
+        model::Map test_map{model::Map::Id{"1"}, "test"};
+        test_map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 20});
+        model::GameSession test_session(&test_map, loot_generator);
+        test_session.SetDogRetirementTime(10s);
+        std::pmr::vector<int> inactive;
+        test_session.AdvanceClock(2s, inactive);
+        auto idle = test_session.AddDog("idle");
+        auto runner = test_session.AddDog("runner");
+        runner->ChangeDirection(model::Direction::EAST);
+
+        WHEN("the idle dog stays long enough"){
+            test_session.AdvanceClock(9999ms, inactive);
+            CHECK(inactive.empty());
+            test_session.AdvanceClock(1ms, inactive);
+            THEN("only it is retired with its own play time"){
+                CHECK(inactive == std::pmr::vector<int>{idle->GetDogId()});
+                CHECK(idle->GetPlayTime() == 10s);
+            }
+        }
+        WHEN("the idle dog starts moving and stops later"){
+            test_session.AdvanceClock(5s, inactive);
+            idle->ChangeDirection(model::Direction::WEST);
+            test_session.AdvanceClock(5s, inactive);
+            idle->StopMove();
+            test_session.AdvanceClock(9s, inactive);
+            CHECK(inactive.empty());
+            test_session.AdvanceClock(1s, inactive);
+            THEN("inactivity is counted from the stop"){
+                CHECK(inactive == std::pmr::vector<int>{idle->GetDogId()});
+                CHECK(idle->GetPlayTime() == 20s);
+            }
+        }
+        WHEN("the running dog is stopped by a player"){
+            runner->ChangeDirection("");
+            test_session.AdvanceClock(10s, inactive);
+            THEN("both dogs are retired"){
+                CHECK(inactive.size() == 2);
+            }
+        }
+        WHEN("a copy of the running dog stops"){
+            model::Dog copy{*runner};
+            copy.StopMove();
+            test_session.AdvanceClock(10s, inactive);
+            THEN("the copy does not take part in the session retirement"){
+                CHECK(inactive == std::pmr::vector<int>{idle->GetDogId()});
+                CHECK(copy.GetPlayTime() == 0ms);
+            }
+        }
+        WHEN("a retired dog leaves the session"){
+            test_session.DeleteDog(idle->GetDogId(), 0ms);
+            test_session.AdvanceClock(20s, inactive);
+            THEN("it is not reported again"){
+                CHECK(inactive.empty());
+                CHECK(idle->GetPlayTime() == 0ms);
+            }
+        }
+    }
+}
+
+SCENARIO("Session snapshot"){
+    GIVEN("game session with a dog"){
+        model::LootGenData loot_generator{0.5, 1};
+        model::Map test_map{model::Map::Id{"1"}, "test"};
+        test_map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 20});
+        model::GameSession test_session(&test_map, loot_generator);
+        auto dog = test_session.AddDog("dog");
+
+        WHEN("a reader holds the published snapshot"){
+            auto snapshot = test_session.GetSnapshot();
+            dog->ChangePosition({5., 0.});
+            test_session.AddLootData({0, 0, {1., 0.}});
+            test_session.PublishSnapshot();
+            THEN("later changes do not touch it"){
+                REQUIRE(snapshot->dogs.size() == 1);
+                CHECK(snapshot->dogs.front().pos.x == 0.);
+                CHECK(snapshot->lost_objects.empty());
+            }
+            AND_THEN("new readers see the latest state"){
+                auto latest = test_session.GetSnapshot();
+                CHECK(latest != snapshot);
+                CHECK(latest->dogs.front().pos.x == 5.);
+                CHECK(latest->lost_objects.size() == 1);
+            }
+        }
+        WHEN("nothing changes between publishes"){
+            auto first = test_session.GetSnapshot().get();
+            test_session.PublishSnapshot();
+            THEN("the same snapshot is served"){
+                CHECK(test_session.GetSnapshot().get() == first);
+            }
+        }
+        WHEN("readers release their snapshots"){
+            const void* first = test_session.GetSnapshot().get();
+            test_session.InvalidateSnapshot();
+            const void* second = test_session.GetSnapshot().get();
+            test_session.InvalidateSnapshot();
+            const void* third = test_session.GetSnapshot().get();
+            THEN("the two buffers are swapped"){
+                CHECK(second != first);
+                CHECK(third == first);
+            }
+        }
+    }
+}
+
+SCENARIO("Points along map roads"){
+    GIVEN("a map with a long road and a short reversed one"){
+        model::Map test_map{model::Map::Id{"1"}, "test"};
+        test_map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 90});
+        test_map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{5, 10}, 0});
+
+        THEN("shares map onto the roads by length"){
+            auto first = test_map.PointAlongRoads(0.);
+            CHECK(first.x == 0.);
+            CHECK(first.y == 0.);
+            auto middle = test_map.PointAlongRoads(0.5);
+            CHECK(middle.x == 50.);
+            CHECK(middle.y == 0.);
+            auto reversed = test_map.PointAlongRoads(0.95);
+            CHECK(reversed.x == 5.);
+            CHECK(reversed.y == 5.);
+            auto last = test_map.PointAlongRoads(1.);
+            CHECK(last.x == 5.);
+            CHECK(last.y == 0.);
+        }
+        WHEN("loot is spawned many times"){
+            model::GameSession test_session(&test_map, model::LootGenData{0.5, 1});
+            test_session.SetSeed(1);
+            for(int i = 0; i < 1000; i++){
+                test_session.AddDog("dog"s + std::to_string(i));
+            }
+            test_session.GenerateNewLoot(1s, 1);
+            THEN("the short road gets its share of the length"){
+                size_t on_short_road = 0;
+                for(const auto& loot : test_session.GetLostObjects()){
+                    if(loot.pos.x == 5. && loot.pos.y >= 0. && loot.pos.y <= 10.){
+                        ++on_short_road;
+                    }
+                }
+                CHECK(test_session.GetLostObjects().size() == 1000);
+                CHECK(on_short_road > 50);
+                CHECK(on_short_road < 150);
+            }
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../src/retired_dogs.h"
+
+namespace test_support {
+
+    // Forgets retired dogs, for tests and benchmarks that run without a database
+    class NullRetiredDogRepository : public model::RetiredDogRepository {
+    public:
+        void Save(model::RetiredDog dog) override {
+        }
+        const std::vector<model::RetiredDog> LoadDataFromDB(int offset, int max_elem) const override {
+            return {};
+        }
+    };
+
+}  // namespace test_support
@@ -0,0 +1,231 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/model.h"
+
+namespace {
+
+    bool IsInside(const model::Position& pos, const model::FieldRoad& road) {
+        constexpr double eps = 1e-10;
+        return road.up_left.x - eps <= pos.x && pos.x <= road.down_right.x + eps &&
+               road.up_left.y - eps <= pos.y && pos.y <= road.down_right.y + eps;
+    }
+
+    std::vector<model::FieldRoad> BruteForceRoads(const model::Map& map, const model::Position& pos) {
+        std::vector<model::FieldRoad> result;
+        for(const auto& road : map.GetRoads()){
+            const auto& start = road.GetStart();
+            const auto& end = road.GetEnd();
+            model::FieldRoad field{{std::min(start.x, end.x) - model::ObjectsWidth::ROAD_WIDTH,
+                                        std::min(start.y, end.y) - model::ObjectsWidth::ROAD_WIDTH},
+                                   {std::max(start.x, end.x) + model::ObjectsWidth::ROAD_WIDTH,
+                                        std::max(start.y, end.y) + model::ObjectsWidth::ROAD_WIDTH}};
+            if(IsInside(pos, field)){
+                result.push_back(field);
+            }
+        }
+        return result;
+    }
+
+    bool SameRoads(const std::vector<model::FieldRoad>& lhs, const std::vector<model::FieldRoad>& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto& l, const auto& r){
+            return l.up_left.x == r.up_left.x && l.up_left.y == r.up_left.y &&
+                   l.down_right.x == r.down_right.x && l.down_right.y == r.down_right.y;
+        });
+    }
+
+}  // namespace
+
+SCENARIO("Road index lookup") {
+    GIVEN("a map with crossing and overlapping roads") {
+        model::Map map{model::Map::Id{"map"}, "map"};
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 40});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{40, 0}, 30});
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{40, 30}, 0});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{0, 0}, 30});
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{10, 0}, 20});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{20, 30}, -5});
+
+        WHEN("position is on a single road") {
+            THEN("only that road is found") {
+                auto roads = map.FindContainRoads({30.2, 0.3});
+                CHECK(roads.size() == 1);
+                CHECK(SameRoads(roads, BruteForceRoads(map, {30.2, 0.3})));
+            }
+        }
+        WHEN("position is on a crossroad") {
+            THEN("all crossing roads are found in map order") {
+                auto roads = map.FindContainRoads({20.1, -0.2});
+                CHECK(roads.size() == 3);
+                CHECK(SameRoads(roads, BruteForceRoads(map, {20.1, -0.2})));
+            }
+        }
+        WHEN("position is on the road border") {
+            THEN("road is found") {
+                CHECK(map.FindContainRoads({40.4, 30.4}).size() == 2);
+                CHECK(map.FindContainRoads({-0.4, 15.}).size() == 1);
+            }
+        }
+        WHEN("position is outside of roads") {
+            THEN("nothing is found") {
+                CHECK(map.FindContainRoads({15., 15.}).empty());
+                CHECK(map.FindContainRoads({40.5, 10.}).empty());
+                CHECK(map.FindContainRoads({5., 0.41}).empty());
+            }
+        }
+        WHEN("positions are scanned over the whole map") {
+            THEN("index matches linear scan") {
+                for(double x = -1.; x <= 41.; x += 0.2){
+                    for(double y = -6.; y <= 31.; y += 0.2){
+                        INFO("x: " << x << ", y: " << y);
+                        CHECK(SameRoads(map.FindContainRoads({x, y}), BruteForceRoads(map, {x, y})));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Road corridors") {
+    GIVEN("a map with collinear, touching and crossing roads") {
+        model::Map map{model::Map::Id{"map"}, "map"};
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 10});
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{20, 0}, 10});
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{21, 0}, 30});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{5, -10}, 10});
+
+        WHEN("position is on collinear roads") {
+            THEN("roads are merged into one corridor") {
+                auto corridor = map.FindCorridor({3., 0.1}, road_index::Axis::HORIZONTAL);
+                REQUIRE(corridor);
+                CHECK(corridor->min.x == -0.4);
+                CHECK(corridor->max.x == 20.4);
+                CHECK(corridor->min.y == -0.4);
+                CHECK(corridor->max.y == 0.4);
+            }
+            AND_THEN("roads with a gap between them are not merged") {
+                auto corridor = map.FindCorridor({25., 0.}, road_index::Axis::HORIZONTAL);
+                REQUIRE(corridor);
+                CHECK(corridor->min.x == 20.6);
+            }
+        }
+        WHEN("position is on a crossroad") {
+            THEN("corridor along the movement axis is chosen") {
+                auto corridor = map.FindCorridor({5., 0.}, road_index::Axis::VERTICAL);
+                REQUIRE(corridor);
+                CHECK(corridor->axis == road_index::Axis::VERTICAL);
+                CHECK(corridor->min.y == -10.4);
+                CHECK(corridor->max.y == 10.4);
+            }
+        }
+        WHEN("there is no corridor along the movement axis") {
+            THEN("perpendicular corridor limits the movement") {
+                auto corridor = map.FindCorridor({5., 3.}, road_index::Axis::HORIZONTAL);
+                REQUIRE(corridor);
+                CHECK(corridor->axis == road_index::Axis::VERTICAL);
+                auto stop = corridor->Clamp({9., 3.});
+                CHECK(stop.x == 5.4);
+                CHECK(stop.y == 3.);
+            }
+        }
+        WHEN("position is outside of roads") {
+            THEN("no corridor is found") {
+                CHECK(!map.FindCorridor({15., 3.}, road_index::Axis::HORIZONTAL));
+            }
+        }
+    }
+    GIVEN("a map where the last road bridges two corridors") {
+        model::Map map{model::Map::Id{"map"}, "map"};
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{0, 30}, 40});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{0, 0}, 10});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{0, 50}, 60});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{0, 10}, 30});
+
+        THEN("the bridged corridors become one and the others stay apart") {
+            auto corridor = map.FindCorridor({0., 20.}, road_index::Axis::VERTICAL);
+            REQUIRE(corridor);
+            CHECK(corridor->min.y == -0.4);
+            CHECK(corridor->max.y == 40.4);
+            auto separate = map.FindCorridor({0., 55.}, road_index::Axis::VERTICAL);
+            REQUIRE(separate);
+            CHECK(separate->min.y == 49.6);
+            CHECK(!map.FindCorridor({0., 45.}, road_index::Axis::VERTICAL));
+        }
+    }
+}
+
+SCENARIO("Dog movement along roads") {
+    using namespace std::literals;
+
+    GIVEN("a map with a long street made of several roads and crossroads") {
+        model::Map map{model::Map::Id{"map"}, "map"};
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 10});
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{10, 0}, 25});
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{25, 0}, 40});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{10, -10}, 10});
+        map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{30, 0}, 10});
+
+        auto make_dog = [](model::Position pos, const std::string& dir){
+            model::Dog dog{0, "dog", pos};
+            dog.SetSpeed(4.);
+            dog.ChangeDirection(dir);
+            return dog;
+        };
+        auto target = [](const model::Dog& dog, std::chrono::milliseconds delta){
+            const auto& pos = dog.GetPosition();
+            const auto& speed = dog.GetSpeed();
+            return model::Position{pos.x + speed.w * delta.count() * model::ConvertValues::MS_TO_S, 
+                                   pos.y + speed.h * delta.count() * model::ConvertValues::MS_TO_S};
+        };
+
+        WHEN("dog crosses several roads and junctions in one long tick") {
+            auto dog = make_dog({1., 0.2}, model::Direction::EAST);
+            auto move = model::MoveDog(map, dog, target(dog, 20s));
+            THEN("it stops exactly at the end of the street") {
+                CHECK(move.blocked);
+                CHECK(move.end == geom::Point2D{40.4, 0.2});
+                CHECK(std::abs(move.distance - 39.4) < 1e-10);
+                CHECK(dog.GetSpeed().w == 0);
+            }
+        }
+        WHEN("the same movement is split into short ticks") {
+            auto long_dog = make_dog({1., 0.2}, model::Direction::EAST);
+            auto short_dog = make_dog({1., 0.2}, model::Direction::EAST);
+            model::MoveDog(map, long_dog, target(long_dog, 7s));
+            double distance = 0;
+            for(int i = 0; i < 350; i++){
+                distance += model::MoveDog(map, short_dog, target(short_dog, 20ms)).distance;
+            }
+            THEN("dogs end up at the same point") {
+                CHECK(std::abs(long_dog.GetPosition().x - short_dog.GetPosition().x) < 1e-9);
+                CHECK(long_dog.GetPosition().y == short_dog.GetPosition().y);
+                CHECK(std::abs(distance - 28.) < 1e-9);
+            }
+        }
+        WHEN("dog turns at a crossroad") {
+            auto dog = make_dog({30.2, 0.1}, model::Direction::SOUTH);
+            auto move = model::MoveDog(map, dog, target(dog, 10s));
+            THEN("it runs along the side road until its end") {
+                CHECK(move.blocked);
+                CHECK(move.end == geom::Point2D{30.2, 10.4});
+            }
+        }
+        WHEN("dog moves across a road") {
+            auto dog = make_dog({5., 0.}, model::Direction::NORTH);
+            auto move = model::MoveDog(map, dog, target(dog, 1s));
+            THEN("it stops at the road border") {
+                CHECK(move.blocked);
+                CHECK(move.end == geom::Point2D{5., -0.4});
+                CHECK(std::abs(move.distance - 0.4) < 1e-10);
+            }
+        }
+        WHEN("dog does not leave the road") {
+            auto dog = make_dog({5., 0.}, model::Direction::WEST);
+            auto move = model::MoveDog(map, dog, target(dog, 1s));
+            THEN("it keeps moving") {
+                CHECK(!move.blocked);
+                CHECK(move.end == geom::Point2D{1., 0.});
+                CHECK(dog.GetSpeed().w == -4.);
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/simulation_clock.h"
+
+using namespace std::literals;
+
+SCENARIO("Fixed step simulation clock") {
+    GIVEN("a clock with 20ms step and 5 substeps per wake-up") {
+        ticker::SimulationClock clock{20ms, 5};
+
+        WHEN("elapsed time is shorter than a step") {
+            auto advance = clock.Add(15ms);
+            THEN("nothing is simulated and time is kept") {
+                CHECK(advance.steps == 0);
+                CHECK(advance.dropped == 0ms);
+                CHECK(clock.GetPending() == 15ms);
+            }
+            AND_THEN("the remainder is used on the next wake-up") {
+                advance = clock.Add(30ms);
+                CHECK(advance.steps == 2);
+                CHECK(clock.GetPending() == 5ms);
+            }
+        }
+        WHEN("the process stalls for a long time") {
+            auto advance = clock.Add(1000ms);
+            THEN("substeps are capped and the rest of the whole steps is dropped") {
+                CHECK(advance.steps == 5);
+                CHECK(advance.dropped == 900ms);
+                CHECK(clock.GetPending() == 0ms);
+                CHECK(clock.GetTotalDropped() == 900ms);
+            }
+        }
+        WHEN("wake-ups are irregular") {
+            int steps = 0;
+            for (auto elapsed : {7ms, 33ms, 18ms, 52ms, 10ms}) {
+                steps += clock.Add(elapsed).steps;
+            }
+            THEN("simulated time never runs ahead of the wall time") {
+                CHECK(steps == 6);
+                CHECK(clock.GetPending() == 0ms);
+                CHECK(clock.GetTotalDropped() == 0ms);
+            }
+        }
+    }
+}
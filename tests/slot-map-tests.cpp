@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/slot_map.h"
+
+#include <algorithm>
+#include <string>
+
+using slot_map::Handle;
+using slot_map::SlotMap;
+
+SCENARIO("Slot map") {
+    GIVEN("a slot map with a few values") {
+        SlotMap<std::string> map;
+        const Handle a = map.Insert("a");
+        const Handle b = map.Insert("b");
+        const Handle c = map.Insert("c");
+
+        WHEN("a value in the middle is erased") {
+            map.Erase(a);
+            THEN("the others are still found by their handles") {
+                CHECK(map.Size() == 2);
+                CHECK(map.At(b) == "b");
+                CHECK(map.At(c) == "c");
+                CHECK(map.Values().size() == 2);
+            }
+            THEN("the erased handle is stale") {
+                CHECK(!map.Contains(a));
+                CHECK_THROWS_AS(map.At(a), std::out_of_range);
+                CHECK_THROWS_AS(map.Erase(a), std::out_of_range);
+            }
+            AND_WHEN("a new value reuses the slot") {
+                const Handle d = map.Insert("d");
+                THEN("the old handle does not see it") {
+                    CHECK(d.index == a.index);
+                    CHECK(d.generation != a.generation);
+                    CHECK(!map.Contains(a));
+                    CHECK(map.At(d) == "d");
+                    CHECK(map.SlotCount() == 3);
+                }
+            }
+        }
+        WHEN("handles are packed into ids") {
+            map.Erase(b);
+            const Handle d = map.Insert("d");
+            THEN("they survive the round trip") {
+                CHECK(Handle::FromId(d.ToId()) == d);
+                CHECK(d.ToId() != b.ToId());
+            }
+        }
+        WHEN("values are looked up by dense position") {
+            map.Erase(b);
+            THEN("every position maps back to a live handle") {
+                for (size_t i = 0; i < map.Size(); i++) {
+                    CHECK(map.At(map.HandleAt(i)) == map.Values()[i]);
+                }
+            }
+        }
+        WHEN("the map is cleared") {
+            map.Clear();
+            THEN("no handle is live") {
+                CHECK(map.Size() == 0);
+                CHECK(!map.Contains(a));
+                CHECK(!map.Contains(b));
+                CHECK(!map.Contains(c));
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/spatial_hash.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <tuple>
+
+using collision_detector::GatheringEvent;
+using collision_detector::Gatherer;
+using collision_detector::Item;
+using collision_detector::SpatialHash;
+
+namespace {
+
+    bool SameEvents(std::pmr::vector<GatheringEvent> lhs, std::pmr::vector<GatheringEvent> rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        auto less = [](const GatheringEvent& a, const GatheringEvent& b) {
+            return std::tie(a.gatherer_id, a.item_id) < std::tie(b.gatherer_id, b.item_id);
+        };
+        std::sort(lhs.begin(), lhs.end(), less);
+        std::sort(rhs.begin(), rhs.end(), less);
+        for (size_t i = 0; i < lhs.size(); i++) {
+            if (lhs[i].item_id != rhs[i].item_id || lhs[i].gatherer_id != rhs[i].gatherer_id
+                || lhs[i].time != rhs[i].time || lhs[i].sq_distance != rhs[i].sq_distance) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}  // namespace
+
+SCENARIO("Loot spatial hash") {
+    GIVEN("a hash that follows a set of items") {
+        SpatialHash hash{2.};
+        std::map<size_t, Item> items;
+        size_t next_id = 100;
+        auto push = [&](const Item& item) {
+            items.emplace(next_id, item);
+            hash.Insert(next_id++, item);
+        };
+        auto remove = [&](size_t id) {
+            items.erase(id);
+            hash.Erase(id);
+        };
+
+        WHEN("items are added and removed") {
+            push({{0.5, 0.}, 0.});
+            push({{5., 0.}, 0.});
+            push({{9.5, 0.}, 0.});
+            remove(100);
+            std::vector<Gatherer> gatherers{{1, {0., 0.}, {10., 0.}, 0.6}};
+            auto events = FindGatherEvents(hash, gatherers);
+            THEN("the others keep their ids") {
+                REQUIRE(hash.Size() == 2);
+                REQUIRE(events.size() == 2);
+                CHECK(events[0].item_id == 101);
+                CHECK(events[1].item_id == 102);
+            }
+            AND_THEN("an id can not be used twice") {
+                CHECK_THROWS(hash.Insert(101, {{0., 0.}, 0.}));
+            }
+        }
+        WHEN("a slot is reused by an id of a newer generation") {
+            const size_t old_id = 7;
+            const size_t new_id = (size_t{1} << 32) | 7;
+            hash.ReserveArea({0., 0.}, {10., 0.}, 2);
+            hash.Insert(old_id, {{1., 0.}, 0.});
+            hash.Erase(old_id);
+            hash.Insert(new_id, {{3., 0.}, 0.});
+            hash.Erase(old_id);
+            std::vector<Gatherer> gatherers{{1, {0., 0.}, {10., 0.}, 0.6}};
+            auto events = FindGatherEvents(hash, gatherers);
+            THEN("the stale id does not erase the new item") {
+                CHECK(hash.Size() == 1);
+                REQUIRE(events.size() == 1);
+                CHECK(events[0].item_id == new_id);
+            }
+        }
+        WHEN("a long random history of spawns and pickups is replayed") {
+            std::mt19937 generator{5};
+            std::uniform_real_distribution<double> coord{-30., 30.};
+            std::uniform_real_distribution<double> step{-3., 3.};
+            bool same = true;
+            for (int round = 0; round < 200; round++) {
+                for (int i = 0; i < 5; i++) {
+                    push({{coord(generator), coord(generator)}, 0.});
+                }
+                for (int i = 0; i < 3 && !items.empty(); i++) {
+                    auto it = std::next(items.begin(), std::uniform_int_distribution<size_t>{0, items.size() - 1}(generator));
+                    remove(it->first);
+                }
+                std::vector<Item> dense;
+                std::vector<size_t> ids;
+                for (const auto& [id, item] : items) {
+                    ids.push_back(id);
+                    dense.push_back(item);
+                }
+                std::vector<Gatherer> gatherers;
+                for (size_t i = 0; i < 20; i++) {
+                    geom::Point2D start{coord(generator), coord(generator)};
+                    gatherers.push_back({i, start, {start.x + step(generator), start.y}, 0.6});
+                }
+                // one dog runs across the whole map
+                gatherers.push_back({20, {-40., 0.}, {40., 0.}, 0.6});
+                auto brute_force = FindGatherEvents(std::span<const Item>{dense}, gatherers);
+                for (auto& event : brute_force) {
+                    event.item_id = ids[event.item_id];
+                }
+                same = same && SameEvents(FindGatherEvents(hash, gatherers), brute_force);
+            }
+            THEN("queries match the brute-force search") {
+                CHECK(same);
+                CHECK(hash.Size() == items.size());
+            }
+            AND_WHEN("the hash is cleared") {
+                hash.Clear();
+                THEN("nothing is found") {
+                    std::vector<Gatherer> gatherers{{0, {-40., 0.}, {40., 0.}, 100.}};
+                    CHECK(hash.Size() == 0);
+                    CHECK(FindGatherEvents(hash, gatherers).empty());
+                }
+            }
+        }
+    }
+}
@@ -68,3 +68,54 @@ SCENARIO_METHOD(Fixture, "Dog Serialization") {
         }
     }
 }
+
+SCENARIO_METHOD(Fixture, "Session Serialization") {
+    GIVEN("a session with dogs and lost objects") {
+        Map map{Map::Id{"map1"}, "Map 1"};
+        map.AddRoad(Road{Road::HORIZONTAL, Point{0, 0}, 20});
+        GameSession session{&map, LootGenData{1., 0.}};
+        auto pluto = session.AddDog("Pluto"s);
+        pluto->AddScore(7);
+        session.AddDog("Goofy"s);
+        session.AddLootData({3, 1, {4., 0.}});
+
+        WHEN("session is serialized and changed afterwards") {
+            {
+                serialization::SessionRepr repr{session};
+                session.AddDog("Late"s);
+                session.AddLootData({4, 0, {5., 0.}});
+                output_archive << static_cast<const serialization::SessionRepr&>(repr);
+            }
+
+            THEN("the archive holds the state at the moment of the capture") {
+                InputArchive input_archive{strm};
+                serialization::SessionRepr repr;
+                input_archive >> repr;
+                CHECK(repr.GetMapId() == "map1"s);
+                REQUIRE(repr.GetDogs().size() == 2);
+                const auto restored = repr.GetDogs().front().Restore();
+                CHECK(restored.GetDogName() == "Pluto"s);
+                CHECK(restored.GetScore() == 7);
+                REQUIRE(repr.GetLostObj().size() == 1);
+                CHECK(repr.GetLostObj().front().id == 3);
+            }
+            AND_THEN("the restored state can be saved again") {
+                InputArchive input_archive{strm};
+                serialization::SessionRepr loaded;
+                input_archive >> loaded;
+                std::stringstream copy_strm;
+                {
+                    OutputArchive copy_archive{copy_strm};
+                    copy_archive << static_cast<const serialization::SessionRepr&>(loaded);
+                }
+                InputArchive copy_input{copy_strm};
+                serialization::SessionRepr repr;
+                copy_input >> repr;
+                CHECK(repr.GetMapId() == "map1"s);
+                CHECK(repr.GetDogs().size() == 2);
+                REQUIRE(repr.GetLostObj().size() == 1);
+                CHECK(repr.GetLostObj().front().id == 3);
+            }
+        }
+    }
+}
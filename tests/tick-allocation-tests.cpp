@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "../src/app.h"
+#include "null_retired_dogs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    std::atomic<bool> count_allocations{false};
+    std::atomic<size_t> allocations{0};
+
+    void* CountedAlloc(std::size_t size, std::size_t alignment) {
+        if (count_allocations.load(std::memory_order_relaxed)) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        size = size ? size : 1;
+        void* p = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                                                        : std::malloc(size);
+        if (!p) {
+            throw std::bad_alloc{};
+        }
+        return p;
+    }
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    return CountedAlloc(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return CountedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+SCENARIO("Tick memory allocations") {
+    using namespace std::literals;
+
+    GIVEN("a game with moving dogs, lost objects and an office") {
+        // with spawning on, picked up loot is replaced by new loot all the time
+        const double loot_probability = GENERATE(0., 1.);
+        model::Map map{model::Map::Id{"map"}, "map"};
+        for (int i = 0; i <= 40; i += 10) {
+            map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, i}, 40});
+            map.AddRoad(model::Road{model::Road::VERTICAL, model::Point{i, 0}, 40});
+        }
+        map.AddOffice(model::Office{model::Office::Id{"office"}, {20, 20}, {0, 0}});
+        map.SetScoreForLoot(10);
+
+        model::Game game;
+        game.AddMap(map, 4., 3);
+        game.SetLootGenData(5., loot_probability);
+        game.SetDogRetirementTime(1000.);
+        game.SetRandomaizer();
+        game.SetSeed(42);
+
+        test_support::NullRetiredDogRepository retired_dogs;
+        app::Application app{game, retired_dogs};
+        auto session = game.FindSession(model::Map::Id{"map"});
+        std::vector<std::shared_ptr<model::Dog>> dogs;
+        for (int i = 0; i < 50; i++) {
+            dogs.push_back(session->FindDog(app.JoinGame("map", "dog"s + std::to_string(i)).user_id));
+        }
+        for (int i = 0; i < 200 && loot_probability == 0.; i++) {
+            session->AddLootData({i, 0, {static_cast<double>(i % 41), static_cast<double>(i % 5 * 10)}});
+        }
+
+        const std::string directions[] = {model::Direction::NORTH, model::Direction::EAST,
+                                          model::Direction::SOUTH, model::Direction::WEST};
+        auto tick = [&](int number) {
+            for (size_t i = 0; i < dogs.size(); i++) {
+                if ((number + i) % 7 == 0) {
+                    dogs[i]->ChangeDirection(directions[(number + i) % 4]);
+                }
+            }
+            app.Tick(50ms);
+        };
+        auto last_loot_id = [&] {
+            int last = -1;
+            for (const auto& loot : session->GetLostObjects()) {
+                last = std::max(last, loot.id);
+            }
+            return last;
+        };
+
+        WHEN("the arena has grown to the steady state size") {
+            int number = 0;
+            for (; number < 20; number++) {
+                tick(number);
+            }
+            const int loot_before = last_loot_id();
+            allocations = 0;
+            count_allocations = true;
+            for (; number < 120; number++) {
+                tick(number);
+            }
+            count_allocations = false;
+
+            THEN("ticks do not allocate from the global heap") {
+                CHECK(allocations == 0);
+                CHECK(session->GetLostObjects().size() < 200);
+                CHECK((loot_probability == 0. || last_loot_id() > loot_before));
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/tick_budget.h"
+
+using namespace std::literals;
+using tick_budget::Level;
+using tick_budget::TickBudget;
+
+SCENARIO("Tick budget degradation") {
+    GIVEN("a 10ms tick budget") {
+        TickBudget budget;
+        budget.SetBudget(10ms);
+
+        WHEN("a single tick is over budget") {
+            budget.Record(15ms);
+            THEN("the level does not change") {
+                CHECK(budget.GetLevel() == Level::NORMAL);
+            }
+        }
+        WHEN("several ticks in a row are over budget") {
+            for (int i = 0; i < TickBudget::ESCALATE_AFTER; i++) {
+                budget.Record(15ms);
+            }
+            THEN("work is degraded one level") {
+                CHECK(budget.GetLevel() == Level::REDUCED_LOOT);
+            }
+            AND_WHEN("overload continues") {
+                for (int i = 0; i < TickBudget::ESCALATE_AFTER * 10; i++) {
+                    budget.Record(15ms);
+                }
+                THEN("the level stops at the deepest one") {
+                    CHECK(budget.GetLevel() == Level::DEFERRED_RETIREMENT);
+                }
+            }
+            AND_WHEN("ticks fit the budget with a margin") {
+                for (int i = 0; i < TickBudget::RECOVER_AFTER - 1; i++) {
+                    budget.Record(5ms);
+                }
+                CHECK(budget.GetLevel() == Level::REDUCED_LOOT);
+                budget.Record(5ms);
+                THEN("the level recovers after a long enough streak") {
+                    CHECK(budget.GetLevel() == Level::NORMAL);
+                }
+            }
+            AND_WHEN("ticks are just under the budget") {
+                for (int i = 0; i < TickBudget::RECOVER_AFTER * 2; i++) {
+                    budget.Record(9ms);
+                }
+                THEN("the level is kept") {
+                    CHECK(budget.GetLevel() == Level::REDUCED_LOOT);
+                }
+            }
+        }
+        WHEN("slow ticks are interleaved with normal ones") {
+            for (int i = 0; i < TickBudget::ESCALATE_AFTER * 10; i++) {
+                budget.Record(i % 2 ? 15ms : 9ms);
+            }
+            THEN("the level does not change") {
+                CHECK(budget.GetLevel() == Level::NORMAL);
+            }
+        }
+    }
+    GIVEN("a disabled budget") {
+        TickBudget budget;
+        WHEN("ticks are slow") {
+            for (int i = 0; i < TickBudget::ESCALATE_AFTER * 10; i++) {
+                budget.Record(1s);
+            }
+            THEN("work is never degraded") {
+                CHECK(budget.GetLevel() == Level::NORMAL);
+            }
+        }
+        WHEN("a level is set") {
+            budget.SetLevel(Level::SPARSE_COLLISIONS);
+            budget.Record(1ms);
+            THEN("the level is kept") {
+                CHECK(budget.GetLevel() == Level::SPARSE_COLLISIONS);
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "../src/app.h"
+#include "null_retired_dogs.h"
+
+using namespace std::literals;
+using tick_budget::Level;
+
+namespace {
+
+    class CountingRetiredDogRepository : public model::RetiredDogRepository {
+    public:
+        void Save(model::RetiredDog dog) override {
+            ++saved;
+        }
+        const std::vector<model::RetiredDog> LoadDataFromDB(int offset, int max_elem) const override {
+            return {};
+        }
+
+        int saved = 0;
+    };
+
+    model::Map MakeMap() {
+        model::Map map{model::Map::Id{"map"}, "map"};
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, model::Point{0, 0}, 100});
+        return map;
+    }
+
+}  // namespace
+
+SCENARIO("Loot generation under a reduced loot level") {
+    GIVEN("two games with a standing dog and loot expected after a second") {
+        auto make_game = [](model::Game& game) {
+            game.AddMap(MakeMap(), 1., 3);
+            game.SetLootGenData(1., 0.5);
+            game.SetDogRetirementTime(1000.);
+            game.FindSession(model::Map::Id{"map"})->AddDog("dog");
+        };
+        model::Game normal_game;
+        model::Game reduced_game;
+        make_game(normal_game);
+        make_game(reduced_game);
+        test_support::NullRetiredDogRepository retired_dogs;
+        app::TickUseCase normal{normal_game, retired_dogs};
+        app::TickUseCase reduced{reduced_game, retired_dogs};
+        reduced.SetDegradationLevel(Level::REDUCED_LOOT);
+
+        WHEN("both games are ticked for the same time") {
+            for (int i = 0; i < 24; i++) {
+                normal.Tick(50ms);
+                reduced.Tick(50ms);
+            }
+            THEN("the skipped ticks are carried to the next generation") {
+                CHECK(reduced.GetDegradationLevel() == Level::REDUCED_LOOT);
+                CHECK(normal_game.FindSession(model::Map::Id{"map"})->GetLostObjects().size() == 1);
+                CHECK(reduced_game.FindSession(model::Map::Id{"map"})->GetLostObjects().size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Movement under a sparse collisions level") {
+    GIVEN("a game with a dog running east") {
+        const double speed = GENERATE(1., 4.);
+        model::Game game;
+        game.AddMap(MakeMap(), speed, 3);
+        game.SetLootGenData(1., 0.);
+        game.SetDogRetirementTime(1000.);
+        auto dog = game.FindSession(model::Map::Id{"map"})->AddDog("dog");
+        dog->ChangeDirection(model::Direction::EAST);
+
+        test_support::NullRetiredDogRepository retired_dogs;
+        app::TickUseCase tick{game, retired_dogs};
+        tick.SetDegradationLevel(Level::SPARSE_COLLISIONS);
+        const double step = speed * 0.05;
+
+        WHEN("the game is ticked") {
+            tick.Tick(50ms);
+            const double first = dog->GetPosition().x;
+            tick.Tick(50ms);
+            const double second = dog->GetPosition().x;
+            tick.Tick(50ms);
+            const double third = dog->GetPosition().x;
+
+            THEN("a slow session skips every other tick and catches up on the next one") {
+                if (speed == 1.) {
+                    CHECK(first == Catch::Approx(step));
+                    CHECK(second == first);
+                    CHECK(third == Catch::Approx(3 * step));
+                }
+            }
+            THEN("a session moving further than the gather radius is never skipped") {
+                if (speed == 4.) {
+                    CHECK(first == Catch::Approx(step));
+                    CHECK(second == Catch::Approx(2 * step));
+                    CHECK(third == Catch::Approx(3 * step));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Retirement under a deferred retirement level") {
+    GIVEN("a game with a dog about to retire") {
+        model::Game game;
+        game.AddMap(MakeMap(), 1., 3);
+        game.SetLootGenData(1., 0.);
+        game.SetDogRetirementTime(0.1);
+        auto session = game.FindSession(model::Map::Id{"map"});
+        session->AddDog("dog");
+
+        CountingRetiredDogRepository retired_dogs;
+        app::TickUseCase tick{game, retired_dogs};
+        tick.SetDegradationLevel(Level::DEFERRED_RETIREMENT);
+
+        WHEN("the dog retires") {
+            for (int i = 0; i < 4; i++) {
+                tick.Tick(50ms);
+            }
+            THEN("it leaves the session but is not saved yet") {
+                CHECK(session->GetInfoDogs().empty());
+                CHECK(retired_dogs.saved == 0);
+            }
+            AND_WHEN("the level drops") {
+                tick.SetDegradationLevel(Level::SPARSE_COLLISIONS);
+                tick.Tick(50ms);
+                THEN("the queued dog is saved") {
+                    CHECK(retired_dogs.saved == 1);
+                }
+            }
+        }
+    }
+}
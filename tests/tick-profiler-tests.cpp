@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/tick_profiler.h"
+
+#include <thread>
+#include <vector>
+
+SCENARIO("Tick phase histogram") {
+    GIVEN("an empty histogram") {
+        tick_profiler::Histogram histogram;
+        THEN("summary is zero") {
+            auto summary = histogram.GetSummary();
+            CHECK(summary.count == 0);
+            CHECK(summary.p99 == 0);
+            CHECK(summary.max == 0);
+        }
+    }
+    GIVEN("a histogram with uniformly distributed durations") {
+        tick_profiler::Histogram histogram;
+        for (uint64_t value = 1; value <= 100000; value++) {
+            histogram.Record(value);
+        }
+        THEN("percentiles are within the bucket precision") {
+            auto summary = histogram.GetSummary();
+            auto near = [](uint64_t value, uint64_t expected) {
+                return value >= expected && value <= expected + expected / tick_profiler::Histogram::SUB_BUCKETS;
+            };
+            CHECK(summary.count == 100000);
+            CHECK(near(summary.p50, 50000));
+            CHECK(near(summary.p90, 90000));
+            CHECK(near(summary.p99, 99000));
+            CHECK(summary.max == 100000);
+        }
+    }
+    GIVEN("a histogram written from several threads") {
+        tick_profiler::Histogram histogram;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&histogram, t] {
+                for (uint64_t value = 0; value < 10000; value++) {
+                    histogram.Record(value * (t + 1));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        THEN("no sample is lost") {
+            auto summary = histogram.GetSummary();
+            CHECK(summary.count == 40000);
+            CHECK(summary.max == 39996);
+        }
+    }
+}
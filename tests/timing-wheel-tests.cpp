@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/timing_wheel.h"
+
+#include <algorithm>
+#include <list>
+#include <random>
+
+using timing_wheel::Timer;
+using timing_wheel::TimingWheel;
+
+SCENARIO("Hierarchical timing wheel") {
+    GIVEN("an empty wheel") {
+        TimingWheel wheel;
+        std::pmr::vector<int> expired;
+
+        WHEN("timers are scheduled at different levels") {
+            Timer near{1}, middle{2}, far{3}, beyond{4};
+            wheel.Schedule(near, 10);
+            wheel.Schedule(middle, 5000);
+            wheel.Schedule(far, 300000);
+            wheel.Schedule(beyond, (TimingWheel::Time{1} << 25) + 7);
+            THEN("each one expires exactly at its deadline") {
+                wheel.Advance(9, expired);
+                CHECK(expired.empty());
+                wheel.Advance(10, expired);
+                CHECK(expired == std::pmr::vector<int>{1});
+                wheel.Advance(4999, expired);
+                CHECK(expired.size() == 1);
+                wheel.Advance(5000, expired);
+                CHECK(expired.back() == 2);
+                wheel.Advance(299999, expired);
+                CHECK(expired.size() == 2);
+                wheel.Advance(300050, expired);
+                CHECK(expired.back() == 3);
+                wheel.Advance((TimingWheel::Time{1} << 25) + 6, expired);
+                CHECK(expired.size() == 3);
+                wheel.Advance((TimingWheel::Time{1} << 25) + 7, expired);
+                CHECK(expired.back() == 4);
+                CHECK(wheel.Size() == 0);
+                CHECK(!beyond.IsScheduled());
+            }
+        }
+        WHEN("a timer is cancelled or rescheduled") {
+            Timer first{1}, second{2};
+            wheel.Schedule(first, 100);
+            wheel.Schedule(second, 100);
+            wheel.Cancel(first);
+            wheel.Schedule(second, 200);
+            wheel.Advance(150, expired);
+            THEN("only the latest deadline counts") {
+                CHECK(expired.empty());
+                CHECK(!first.IsScheduled());
+                wheel.Advance(200, expired);
+                CHECK(expired == std::pmr::vector<int>{2});
+            }
+        }
+        WHEN("a deadline is already in the past") {
+            wheel.Advance(1000, expired);
+            Timer late{1};
+            wheel.Schedule(late, 500);
+            wheel.Advance(1001, expired);
+            THEN("it expires on the next advance") {
+                CHECK(expired == std::pmr::vector<int>{1});
+            }
+        }
+        WHEN("a scheduled timer is destroyed") {
+            {
+                Timer temporary{1};
+                wheel.Schedule(temporary, 100);
+                CHECK(wheel.Size() == 1);
+            }
+            wheel.Advance(200, expired);
+            THEN("it leaves the wheel") {
+                CHECK(wheel.Size() == 0);
+                CHECK(expired.empty());
+            }
+        }
+    }
+    GIVEN("many random timers advanced in irregular steps") {
+        TimingWheel wheel;
+        std::mt19937 generator{42};
+        std::uniform_int_distribution<TimingWheel::Time> deadline_dist{1, 400000};
+        std::uniform_int_distribution<TimingWheel::Time> step_dist{1, 2000};
+
+        std::list<Timer> timers;
+        std::vector<TimingWheel::Time> deadlines;
+        for (int i = 0; i < 2000; i++) {
+            deadlines.push_back(deadline_dist(generator));
+            wheel.Schedule(timers.emplace_back(i), deadlines.back());
+        }
+
+        WHEN("the wheel runs past the last deadline") {
+            std::pmr::vector<int> expired;
+            bool in_time = true;
+            while (wheel.GetNow() < 400000) {
+                const auto from = wheel.GetNow();
+                const size_t first = expired.size();
+                wheel.Advance(from + step_dist(generator), expired);
+                for (size_t i = first; i < expired.size(); i++) {
+                    const auto deadline = deadlines[expired[i]];
+                    in_time = in_time && deadline > from && deadline <= wheel.GetNow();
+                }
+            }
+            THEN("every timer expires once within the step of its deadline") {
+                CHECK(in_time);
+                std::sort(expired.begin(), expired.end());
+                CHECK(expired.size() == deadlines.size());
+                CHECK(std::adjacent_find(expired.begin(), expired.end()) == expired.end());
+                CHECK(wheel.Size() == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/xoshiro.h"
+
+#include <vector>
+
+using xoshiro::Xoshiro256StarStar;
+
+namespace {
+
+    std::vector<std::uint64_t> Draw(Xoshiro256StarStar& generator, int count) {
+        std::vector<std::uint64_t> values;
+        for (int i = 0; i < count; i++) {
+            values.push_back(generator());
+        }
+        return values;
+    }
+
+}  // namespace
+
+SCENARIO("xoshiro256** generator") {
+    GIVEN("the state of the reference implementation") {
+        Xoshiro256StarStar generator{Xoshiro256StarStar::State{1, 2, 3, 4}};
+        THEN("it produces the reference sequence") {
+            CHECK(Draw(generator, 4) == std::vector<std::uint64_t>{11520, 0, 1509978240, 1215971899390074240});
+        }
+    }
+    GIVEN("generators seeded with a number") {
+        Xoshiro256StarStar first{42}, second{42}, other{43};
+        THEN("the same seed repeats the sequence and a close seed does not") {
+            const auto reference = Draw(first, 100);
+            CHECK(Draw(second, 100) == reference);
+            CHECK(Draw(other, 100) != reference);
+        }
+        WHEN("a generator is reseeded") {
+            Draw(first, 10);
+            first.Seed(42);
+            THEN("it starts over") {
+                CHECK(Draw(first, 100) == Draw(second, 100));
+            }
+        }
+    }
+}